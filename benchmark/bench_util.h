@@ -0,0 +1,83 @@
+#ifndef UV_NET_BENCH_UTIL_H
+#define UV_NET_BENCH_UTIL_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// 性能测试公共工具：计时、结果输出与阻塞式TCP客户端
+namespace bench {
+
+inline int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 防止编译器优化掉被测代码的结果
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 输出一行结果：名称、操作数/秒、吞吐量
+inline void Report(const std::string& name, uint64_t ops, uint64_t bytes, int64_t elapsed_ns) {
+    double seconds = elapsed_ns / 1e9;
+    printf("%-36s %12.0f ops/s %10.2f MB/s %8.3f s\n",
+           name.c_str(), ops / seconds, bytes / seconds / (1024.0 * 1024.0), seconds);
+    fflush(stdout);
+}
+
+// 连接到本地端口，失败返回-1
+inline int Connect(const char* ip, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, ip, &addr.sin_addr);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+inline bool WriteAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool ReadAll(int fd, char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = recv(fd, data, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace bench
+
+#endif // UV_NET_BENCH_UTIL_H
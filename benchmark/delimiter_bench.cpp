@@ -0,0 +1,88 @@
+#include "uv_net/simd.h"
+#include "delimiter_protocol.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <string>
+
+using namespace uv_net;
+
+// 分隔符扫描：标量与 SSE2/AVX2 实现对比，以及 DelimiterProtocol 的整体切分吞吐
+// 用法: delimiter_bench [平均行长] [数据大小MB] [轮数]
+
+static std::string MakeLines(size_t avg_line, size_t total) {
+    std::string data;
+    data.reserve(total + avg_line * 2);
+    uint32_t seed = 12345;
+    while (data.size() < total) {
+        seed = seed * 1103515245 + 12345;
+        size_t len = avg_line / 2 + (seed >> 8) % (avg_line + 1);
+        for (size_t i = 0; i < len; ++i) {
+            data.push_back(static_cast<char>('a' + (i + seed) % 26));
+        }
+        data.push_back('\n');
+    }
+    return data;
+}
+
+static void BenchFindByte(SimdLevel level, const std::string& data, int rounds) {
+    uint64_t lines = 0;
+    int64_t start = bench::NowNs();
+    for (int r = 0; r < rounds; ++r) {
+        const char* p = data.data();
+        const char* end = p + data.size();
+        while (p < end) {
+            const char* pos = FindByte(level, p, end, '\n');
+            if (pos == end) {
+                break;
+            }
+            lines++;
+            p = pos + 1;
+        }
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::DoNotOptimize(lines);
+    bench::Report(std::string("FindByte (") + SimdLevelName(level) + ")", lines, data.size() * rounds, elapsed);
+}
+
+// 模拟连接收包：数据按 read_size 分段到达，协议从上次扫描的位置继续
+static void BenchProtocol(const std::string& data, size_t read_size, int rounds) {
+    uint64_t lines = 0;
+    int64_t start = bench::NowNs();
+    for (int r = 0; r < rounds; ++r) {
+        DelimiterProtocol protocol;
+        size_t offset = 0;
+        size_t received = 0;
+        while (received < data.size()) {
+            received += read_size;
+            if (received > data.size()) {
+                received = data.size();
+            }
+            while (offset < received) {
+                PackageInfo info;
+                if (protocol.Parse(data.data() + offset, received - offset, info) != PackageFull) {
+                    break;
+                }
+                offset += info.package_len;
+                lines++;
+            }
+        }
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::DoNotOptimize(lines);
+    bench::Report("DelimiterProtocol (" + std::to_string(read_size) + "B reads)", lines, data.size() * rounds, elapsed);
+}
+
+int main(int argc, char** argv) {
+    size_t avg_line = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 80;
+    size_t total_mb = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 64;
+    int rounds = argc > 3 ? atoi(argv[3]) : 5;
+
+    std::string data = MakeLines(avg_line, total_mb * 1024 * 1024);
+    printf("avg_line=%zu data=%zuMB rounds=%d cpu=%s\n", avg_line, total_mb, rounds, SimdLevelName(GetSimdLevel()));
+
+    BenchFindByte(SimdLevel::SCALAR, data, rounds);
+    BenchFindByte(SimdLevel::SSE2, data, rounds);
+    BenchFindByte(SimdLevel::AVX2, data, rounds);
+    BenchProtocol(data, 8192, rounds);
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "uv_net.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// HttpServer 吞吐：keep-alive 连接上按 pipelining 深度批量发送请求；另测请求解析器本身
+// 用法: http_bench [连接数] [pipelining深度] [每连接批次数]
+
+static const int kHttpPort = 7110;
+static const char kRequest[] =
+    "GET /health?verbose=1 HTTP/1.1\r\n"
+    "Host: 127.0.0.1\r\n"
+    "User-Agent: http_bench\r\n"
+    "Accept: */*\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+static const char kBody[] = "OK";
+
+static void BenchParser(int iterations) {
+    size_t len = sizeof(kRequest) - 1;
+    uint64_t parsed = 0;
+    HttpProtocol protocol;
+    int64_t start = bench::NowNs();
+    for (int i = 0; i < iterations; ++i) {
+        PackageInfo info;
+        if (protocol.Parse(kRequest, len, info) == PackageFull) {
+            parsed++;
+        }
+        bench::DoNotOptimize(protocol.GetRequest().header_count);
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::Report("HttpProtocol::Parse", parsed, parsed * len, elapsed);
+}
+
+static void RunClients(int connections, int depth, int batches, size_t response_size) {
+    std::atomic<uint64_t> responses{0};
+    std::vector<std::thread> clients;
+
+    std::string batch;
+    for (int i = 0; i < depth; ++i) {
+        batch.append(kRequest, sizeof(kRequest) - 1);
+    }
+
+    int64_t start = bench::NowNs();
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&]() {
+            int fd = bench::Connect("127.0.0.1", kHttpPort);
+            if (fd < 0) {
+                fprintf(stderr, "connect failed\n");
+                return;
+            }
+            std::string in(response_size * depth, '\0');
+            for (int i = 0; i < batches; ++i) {
+                if (!bench::WriteAll(fd, batch.data(), batch.size()) || !bench::ReadAll(fd, &in[0], in.size())) {
+                    break;
+                }
+                responses += depth;
+            }
+            close(fd);
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+
+    bench::Report("HttpServer (pipelining " + std::to_string(depth) + ")", responses.load(),
+                  responses.load() * (batch.size() / depth + response_size), elapsed);
+}
+
+// 读取一个响应以确定响应长度（所有响应相同）
+static size_t ProbeResponseSize() {
+    int fd = bench::Connect("127.0.0.1", kHttpPort);
+    if (fd < 0 || !bench::WriteAll(fd, kRequest, sizeof(kRequest) - 1)) {
+        return 0;
+    }
+    std::string in;
+    char buf[1024];
+    while (in.find("\r\n\r\n") == std::string::npos || in.size() < in.find("\r\n\r\n") + 4 + sizeof(kBody) - 1) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            break;
+        }
+        in.append(buf, static_cast<size_t>(n));
+    }
+    close(fd);
+    return in.size();
+}
+
+int main(int argc, char** argv) {
+    int connections = argc > 1 ? atoi(argv[1]) : 8;
+    int depth = argc > 2 ? atoi(argv[2]) : 16;
+    int batches = argc > 3 ? atoi(argv[3]) : 5000;
+
+    BenchParser(2000000);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetReadBufferSize(65536);
+        config.SetMaxSendQueueSize(100000);
+        HttpServer server(loop, config);
+        server.SetOnRequest([](std::shared_ptr<Connection> conn, const HttpRequest& req, HttpResponse& resp) {
+            resp.AddHeader("Content-Type", "text/plain");
+            resp.SetBody(kBody, sizeof(kBody) - 1);
+        });
+
+        if (!server.Start("127.0.0.1", kHttpPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    size_t response_size = ProbeResponseSize();
+    printf("connections=%d depth=%d batches=%d response=%zu bytes\n", connections, depth, batches, response_size);
+    if (response_size > 0) {
+        RunClients(connections, 1, batches, response_size);
+        RunClients(connections, depth, batches, response_size);
+    }
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
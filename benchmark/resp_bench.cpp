@@ -0,0 +1,145 @@
+#include "uv_net.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace uv_net;
+
+// RespServer 吞吐：与 redis-benchmark -P 相同的负载，每个连接一次写入 P 条 SET/GET 命令后读取 P 条回复
+// 用法: resp_bench [连接数] [pipelining深度] [每连接批次数]
+
+static const int kRespPort = 7120;
+static const char kSet[] = "*3\r\n$3\r\nSET\r\n$7\r\nkey:000\r\n$3\r\nxxx\r\n";
+static const char kGet[] = "*2\r\n$3\r\nGET\r\n$7\r\nkey:000\r\n";
+static const char kSetReply[] = "+OK\r\n";
+static const char kGetReply[] = "$3\r\nxxx\r\n";
+
+static void BenchParser(int iterations, int depth) {
+    std::string batch;
+    for (int i = 0; i < depth; ++i) {
+        batch.append(kGet, sizeof(kGet) - 1);
+    }
+    uint64_t commands = 0;
+    RespProtocol protocol;
+    int64_t start = bench::NowNs();
+    for (int i = 0; i < iterations; ++i) {
+        PackageInfo info;
+        if (protocol.Parse(batch.data(), batch.size(), info) == PackageFull) {
+            commands += protocol.GetBatch().Size();
+        }
+        bench::DoNotOptimize(protocol.GetBatch()[0].argc);
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::Report("RespProtocol::Parse (" + std::to_string(depth) + " commands)", commands,
+                  static_cast<uint64_t>(iterations) * batch.size(), elapsed);
+}
+
+static void RunClients(const char* name, const char* command, size_t command_len, size_t reply_len,
+                       int connections, int depth, int batches) {
+    std::atomic<uint64_t> replies{0};
+    std::vector<std::thread> clients;
+
+    std::string batch;
+    for (int i = 0; i < depth; ++i) {
+        batch.append(command, command_len);
+    }
+
+    int64_t start = bench::NowNs();
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&]() {
+            int fd = bench::Connect("127.0.0.1", kRespPort);
+            if (fd < 0) {
+                fprintf(stderr, "connect failed\n");
+                return;
+            }
+            std::string in(reply_len * depth, '\0');
+            for (int i = 0; i < batches; ++i) {
+                if (!bench::WriteAll(fd, batch.data(), batch.size()) || !bench::ReadAll(fd, &in[0], in.size())) {
+                    break;
+                }
+                replies += depth;
+            }
+            close(fd);
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+
+    bench::Report(std::string("RespServer ") + name + " (pipelining " + std::to_string(depth) + ")", replies.load(),
+                  replies.load() * (command_len + reply_len), elapsed);
+}
+
+int main(int argc, char** argv) {
+    int connections = argc > 1 ? atoi(argv[1]) : 8;
+    int depth = argc > 2 ? atoi(argv[2]) : 16;
+    int batches = argc > 3 ? atoi(argv[3]) : 5000;
+
+    BenchParser(1000000, 1);
+    BenchParser(100000, depth);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetReadBufferSize(65536);
+        config.SetMaxSendQueueSize(100000);
+        RespServer server(loop, config);
+
+        std::unordered_map<std::string, std::string> store;
+        server.SetOnCommandBatch([&store](std::shared_ptr<Connection> conn, const RespBatch& batch, RespReply& reply) {
+            for (size_t i = 0; i < batch.Size(); ++i) {
+                RespCommand cmd = batch[i];
+                if (cmd.Is("GET") && cmd.argc == 2) {
+                    auto it = store.find(cmd.args[1].ToString());
+                    if (it == store.end()) {
+                        reply.Null();
+                    } else {
+                        reply.BulkString(it->second);
+                    }
+                } else if (cmd.Is("SET") && cmd.argc == 3) {
+                    store[cmd.args[1].ToString()] = cmd.args[2].ToString();
+                    reply.SimpleString("OK");
+                } else if (cmd.Is("PING")) {
+                    reply.SimpleString("PONG");
+                } else {
+                    reply.Error("ERR unknown command");
+                }
+            }
+        });
+
+        if (!server.Start("127.0.0.1", kRespPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    printf("connections=%d depth=%d batches=%d\n", connections, depth, batches);
+    RunClients("SET", kSet, sizeof(kSet) - 1, sizeof(kSetReply) - 1, connections, 1, batches);
+    RunClients("SET", kSet, sizeof(kSet) - 1, sizeof(kSetReply) - 1, connections, depth, batches);
+    RunClients("GET", kGet, sizeof(kGet) - 1, sizeof(kGetReply) - 1, connections, 1, batches);
+    RunClients("GET", kGet, sizeof(kGet) - 1, sizeof(kGetReply) - 1, connections, depth, batches);
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
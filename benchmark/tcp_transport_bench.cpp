@@ -0,0 +1,102 @@
+#include "uv_net.h"
+#include "uv_net/io_uring_transport.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// libuv 与 io_uring 传输的 echo 往返对比
+// 用法: tcp_transport_bench [连接数] [消息大小] [每连接往返次数]
+
+static const int kUvPort = 7100;
+static const int kIoUringPort = 7101;
+
+static void RunClients(const char* name, int port, int connections, size_t msg_size, int iterations) {
+    std::atomic<uint64_t> round_trips{0};
+    std::vector<std::thread> clients;
+
+    int64_t start = bench::NowNs();
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&, port]() {
+            int fd = bench::Connect("127.0.0.1", port);
+            if (fd < 0) {
+                fprintf(stderr, "%s: connect failed\n", name);
+                return;
+            }
+            std::string out(msg_size, 'x');
+            std::string in(msg_size, '\0');
+            for (int i = 0; i < iterations; ++i) {
+                if (!bench::WriteAll(fd, out.data(), out.size()) || !bench::ReadAll(fd, &in[0], in.size())) {
+                    break;
+                }
+                round_trips++;
+            }
+            close(fd);
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+
+    bench::Report(name, round_trips.load(), round_trips.load() * msg_size * 2, elapsed);
+}
+
+int main(int argc, char** argv) {
+    int connections = argc > 1 ? atoi(argv[1]) : 8;
+    size_t msg_size = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 64;
+    int iterations = argc > 3 ? atoi(argv[3]) : 20000;
+
+    bool io_uring_supported = IoUringLoop::IsSupported();
+    printf("connections=%d msg_size=%zu iterations=%d io_uring=%s\n",
+           connections, msg_size, iterations, io_uring_supported ? "yes" : "no (fallback to libuv)");
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetReadBufferSize(65536);
+        config.SetWriteBufferSize(65536);
+        config.SetMaxSendQueueSize(100000);
+        ServerConfig uring_config = config;
+        uring_config.SetUseIoUring(true);
+
+        TcpServer uv_server(loop, config);
+        TcpServer uring_server(loop, uring_config);
+        auto echo = [](std::shared_ptr<Connection> conn, const char* data, size_t len) {
+            conn->Send(data, len);
+        };
+        uv_server.SetOnMessage(echo);
+        uring_server.SetOnMessage(echo);
+
+        if (!uv_server.Start("127.0.0.1", kUvPort) || !uring_server.Start("127.0.0.1", kIoUringPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    RunClients("TcpServer (libuv)", kUvPort, connections, msg_size, iterations);
+    RunClients("TcpServer (io_uring)", kIoUringPort, connections, msg_size, iterations);
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "uv_net.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// UdpServer 收包速率：逐个 recvmsg + OnMessage、recvmmsg + OnMessage、recvmmsg + OnMessageBatch 对比
+// 以及回显时的发送路径：uv_udp_try_send 逐个发送与循环末尾 sendmmsg 批量发送（SetAutoFlush）对比，
+// 最后是 SetWorkerCount 多个工作线程各自 SO_REUSEPORT 收包（服务器 CPU 为全部工作线程之和）
+// 客户端线程用 sendmmsg 从多个本地端口（模拟多个对端）全速发送，统计服务器每秒交付的数据报数
+// （超出处理能力的部分被内核丢弃）以及服务器线程每个数据报消耗的 CPU 时间（不受发送线程抢占 CPU 的影响）
+// 用法: udp_bench [数据报大小] [发送线程数] [每种模式的秒数] [每个发送线程的对端数] [工作线程数]
+
+static const int kUdpPort = 7170;
+static const int kSendBatch = 64;
+
+enum Mode { kRecvMsg, kRecvMmsg, kRecvMmsgBatch, kEchoTrySend, kEchoSendMmsg, kWorkersBatch };
+
+static int64_t ThreadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// 回显的数据报不读取，由内核在对端 socket 上丢弃
+static void Sender(std::atomic<bool>* running, std::atomic<uint64_t>* sent, size_t size, int peers) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kUdpPort);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    std::vector<int> fds;
+    for (int i = 0; i < peers; ++i) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+        fds.push_back(fd);
+    }
+
+    std::vector<char> payload(size, 'x');
+    struct iovec iov[kSendBatch];
+    struct mmsghdr msgs[kSendBatch];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < kSendBatch; ++i) {
+        iov[i].iov_base = payload.data();
+        iov[i].iov_len = size;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    uint64_t count = 0;
+    size_t next = 0;
+    while (running->load(std::memory_order_relaxed)) {
+        int n = sendmmsg(fds[next], msgs, kSendBatch, 0);
+        if (n > 0) {
+            count += static_cast<uint64_t>(n);
+        }
+        next = (next + 1) % fds.size();
+    }
+    sent->fetch_add(count);
+    for (int fd : fds) {
+        close(fd);
+    }
+}
+
+static void Run(Mode mode, size_t size, int threads, int seconds, int peers, int workers) {
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<int64_t> server_cpu{0};
+
+    std::thread server_thread([&]() {
+        uv_loop_t loop;
+        uv_loop_init(&loop);
+        {
+            ServerConfig config;
+            config.SetAutoFlush(mode == kEchoSendMmsg);
+            UdpServer server(&loop, config);
+            server.SetRecvMmsg(mode != kRecvMsg);
+            server.SetSocketRecvBufferSize(4 * 1024 * 1024);
+            if (mode == kRecvMmsgBatch) {
+                server.SetOnMessageBatch([&](const UdpDatagram* datagrams, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        bench::DoNotOptimize(datagrams[i].data[0]);
+                    }
+                    received += count;
+                    wakeups++;
+                });
+            } else if (mode == kWorkersBatch) {
+                // 工作线程的 CPU 时间：每个线程记录第一次回调前的起点，每次回调后累加增量
+                server.SetWorkerCount(workers);
+                server.SetOnMessageBatch([&](const UdpDatagram* datagrams, size_t count) {
+                    thread_local int64_t last_cpu = 0;
+                    if (last_cpu == 0) {
+                        last_cpu = ThreadCpuNs();
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        bench::DoNotOptimize(datagrams[i].data[0]);
+                    }
+                    received += count;
+                    wakeups++;
+                    int64_t now = ThreadCpuNs();
+                    server_cpu += now - last_cpu;
+                    last_cpu = now;
+                });
+            } else if (mode == kEchoTrySend || mode == kEchoSendMmsg) {
+                server.SetOnMessageBatch([&](const UdpDatagram* datagrams, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        server.SendTo(datagrams[i].addr, datagrams[i].data, datagrams[i].len);
+                    }
+                    received += count;
+                    wakeups++;
+                });
+            } else {
+                server.SetOnMessage([&](std::shared_ptr<Connection> conn, const char* data, size_t len) {
+                    bench::DoNotOptimize(data[0]);
+                    received++;
+                });
+            }
+            if (!server.Start("127.0.0.1", kUdpPort)) {
+                fprintf(stderr, "server start failed\n");
+                exit(1);
+            }
+            uv_async_init(&loop, &stop_async, [](uv_async_t* handle) {
+                uv_stop(handle->loop);
+            });
+            ready = true;
+            int64_t cpu_start = ThreadCpuNs();
+            uv_run(&loop, UV_RUN_DEFAULT);
+            server_cpu += ThreadCpuNs() - cpu_start;
+            uv_close((uv_handle_t*)&stop_async, nullptr);
+        }
+        uv_run(&loop, UV_RUN_DEFAULT);
+        uv_loop_close(&loop);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> sent{0};
+    std::vector<std::thread> senders;
+    int64_t start = bench::NowNs();
+    for (int t = 0; t < threads; ++t) {
+        senders.emplace_back(Sender, &running, &sent, size, peers);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto& t : senders) {
+        t.join();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    // 留出时间处理 socket 缓冲区中剩余的数据报
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uv_async_send(&stop_async);
+    server_thread.join();
+
+    static const char* kNames[] = {"recvmsg + OnMessage", "recvmmsg + OnMessage", "recvmmsg + OnMessageBatch",
+                                   "echo SendTo uv_udp_try_send", "echo SendTo sendmmsg batch",
+                                   "recvmmsg + OnMessageBatch, workers"};
+    char name[64];
+    if (mode == kWorkersBatch) {
+        snprintf(name, sizeof(name), "%s=%d", kNames[mode], workers);
+    } else {
+        snprintf(name, sizeof(name), "%s", kNames[mode]);
+    }
+    uint64_t total = received.load();
+    bench::Report(name, total, total * size, elapsed);
+    printf("    sent %llu, delivered %.1f%%, server cpu %.0f ns/datagram", (unsigned long long)sent.load(),
+           sent.load() ? 100.0 * total / sent.load() : 0.0, total ? static_cast<double>(server_cpu.load()) / total : 0.0);
+    if (wakeups > 0) {
+        printf(", %.1f datagrams per batch", static_cast<double>(total) / wakeups.load());
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    size_t size = argc > 1 ? static_cast<size_t>(atoi(argv[1])) : 64;
+    int threads = argc > 2 ? atoi(argv[2]) : 1;
+    int seconds = argc > 3 ? atoi(argv[3]) : 3;
+    int peers = argc > 4 ? atoi(argv[4]) : 64;
+    int workers = argc > 5 ? atoi(argv[5]) : 4;
+    printf("datagram=%zu senders=%d seconds=%d peers=%d workers=%d cpus=%u\n", size, threads, seconds, threads * peers,
+           workers, uv_available_parallelism());
+
+    Run(kRecvMsg, size, threads, seconds, peers, workers);
+    Run(kRecvMmsg, size, threads, seconds, peers, workers);
+    Run(kRecvMmsgBatch, size, threads, seconds, peers, workers);
+    Run(kEchoTrySend, size, threads, seconds, peers, workers);
+    Run(kEchoSendMmsg, size, threads, seconds, peers, workers);
+    Run(kWorkersBatch, size, threads, seconds, peers, workers);
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "uv_net.h"
+#include "uv_net/websocket_deflate.h"
+#include "uv_net/websocket_frame.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace uv_net;
+
+// permessage-deflate：JSON 消息的压缩率与吞吐、广播时逐连接压缩与 PreparedFrame 只压缩一次的对比、各配置下每连接的 zlib 内存
+// 用法: ws_deflate_bench [消息条数] [广播连接数]
+
+// 行情推送风格的 JSON 消息，字段名重复、数值变化
+static std::string MakeMessage(int seq) {
+    std::string msg = "{\"type\":\"ticker\",\"seq\":" + std::to_string(seq) + ",\"data\":[";
+    for (int i = 0; i < 12; ++i) {
+        if (i > 0) {
+            msg += ",";
+        }
+        msg += "{\"symbol\":\"SYM" + std::to_string(i) + "\",\"price\":" + std::to_string(1000 + (seq * 7 + i * 13) % 500) +
+               ".25,\"volume\":" + std::to_string((seq * 31 + i * 17) % 100000) + ",\"change\":-0.0" +
+               std::to_string((seq + i) % 10) + "}";
+    }
+    msg += "]}";
+    return msg;
+}
+
+static void BenchCompress(const std::vector<std::string>& messages, bool no_context_takeover, int window_bits) {
+    WebSocketDeflateOptions options;
+    options.enabled = true;
+    WebSocketDeflateParams params;
+    params.server_max_window_bits = window_bits;
+    params.server_no_context_takeover = no_context_takeover;
+    WebSocketDeflate deflate(params, options);
+
+    uint64_t raw = 0;
+    uint64_t compressed = 0;
+    int64_t start = bench::NowNs();
+    for (const std::string& msg : messages) {
+        SendBuffer out(kWebSocketMaxHeaderSize, WebSocketDeflate::CompressBound(msg.size()));
+        deflate.Compress(msg.data(), msg.size(), out);
+        raw += msg.size();
+        compressed += out.Size();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    char name[64];
+    snprintf(name, sizeof(name), "compress w=%d %s ratio %.2f", window_bits,
+             no_context_takeover ? "no_ctx" : "ctx", static_cast<double>(compressed) / raw);
+    bench::Report(name, messages.size(), raw, elapsed);
+}
+
+static void BenchDecompress(const std::vector<std::string>& messages) {
+    WebSocketDeflateOptions options;
+    options.enabled = true;
+    WebSocketDeflateParams params;
+    WebSocketDeflate compressor(params, options);
+    std::vector<std::string> frames;
+    uint64_t raw = 0;
+    for (const std::string& msg : messages) {
+        SendBuffer out(kWebSocketMaxHeaderSize, WebSocketDeflate::CompressBound(msg.size()));
+        compressor.Compress(msg.data(), msg.size(), out);
+        frames.emplace_back(out.Data(), out.Size());
+        raw += msg.size();
+    }
+
+    // 服务器方向相反，这里用压缩器的参数作为客户端窗口
+    WebSocketDeflate inflater(params, options);
+    std::vector<char> out;
+    int64_t start = bench::NowNs();
+    for (size_t i = 0; i < frames.size(); ++i) {
+        out.clear();
+        if (inflater.Decompress(frames[i].data(), frames[i].size(), true, out, 1 << 20) != WebSocketDeflate::kOk ||
+            out.size() != messages[i].size()) {
+            fprintf(stderr, "decompress failed\n");
+            exit(1);
+        }
+    }
+    bench::Report("decompress w=15 ctx", frames.size(), raw, bench::NowNs() - start);
+}
+
+// 同一条消息推送给 connections 个连接
+static void BenchBroadcast(const std::vector<std::string>& messages, int connections) {
+    WebSocketDeflateOptions options;
+    options.enabled = true;
+    WebSocketDeflateParams params;
+    std::vector<std::unique_ptr<WebSocketDeflate>> conns;
+    for (int i = 0; i < connections; ++i) {
+        conns.emplace_back(new WebSocketDeflate(params, options));
+    }
+    size_t rounds = messages.size() / 10;
+    uint64_t total = rounds * connections;
+
+    int64_t start = bench::NowNs();
+    for (size_t r = 0; r < rounds; ++r) {
+        const std::string& msg = messages[r];
+        for (auto& conn : conns) {
+            SendBuffer out(kWebSocketMaxHeaderSize, WebSocketDeflate::CompressBound(msg.size()));
+            conn->Compress(msg.data(), msg.size(), out);
+            bench::DoNotOptimize(out.Data()[0]);
+        }
+    }
+    bench::Report("broadcast per-connection Compress", total, total * messages[0].size(), bench::NowNs() - start);
+
+    start = bench::NowNs();
+    for (size_t r = 0; r < rounds; ++r) {
+        const std::string& msg = messages[r];
+        PreparedFrame frame = PreparedFrame::Deflated(msg.data(), msg.size(), WebSocketOpcode::TEXT);
+        for (auto& conn : conns) {
+            // SendPrepared 的实际开销：标记压缩器待重置并引用共享的压缩帧
+            conn->ResetCompressor();
+            Buffer buffer = frame.ToBuffer(true);
+            bench::DoNotOptimize(buffer.Data()[0]);
+        }
+    }
+    bench::Report("broadcast PreparedFrame::Deflated", total, total * messages[0].size(), bench::NowNs() - start);
+}
+
+// 压缩、解压各一条消息后每连接保留的 zlib 内存
+static void ReportMemory(const char* name, int window_bits, int mem_level, bool no_context_takeover) {
+    WebSocketDeflateOptions options;
+    options.enabled = true;
+    options.mem_level = mem_level;
+    WebSocketDeflateParams params;
+    params.server_max_window_bits = window_bits;
+    params.client_max_window_bits = window_bits;
+    params.server_no_context_takeover = no_context_takeover;
+    params.client_no_context_takeover = no_context_takeover;
+
+    WebSocketDeflate deflate(params, options);
+    std::string msg = MakeMessage(1);
+    SendBuffer out(kWebSocketMaxHeaderSize, WebSocketDeflate::CompressBound(msg.size()));
+    deflate.Compress(msg.data(), msg.size(), out);
+    std::vector<char> inflated;
+    deflate.Decompress(out.Data(), out.Size(), true, inflated, 1 << 20);
+    printf("%-36s %10zu bytes/connection idle\n", name, deflate.MemoryUsage());
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 20000;
+    int connections = argc > 2 ? atoi(argv[2]) : 100;
+    std::vector<std::string> messages;
+    for (int i = 0; i < count; ++i) {
+        messages.push_back(MakeMessage(i));
+    }
+    printf("messages=%d size=%zu connections=%d\n", count, messages[0].size(), connections);
+
+    BenchCompress(messages, false, 15);
+    BenchCompress(messages, true, 15);
+    BenchCompress(messages, false, 10);
+    BenchCompress(messages, true, 10);
+    BenchDecompress(messages);
+    BenchBroadcast(messages, connections);
+
+    ReportMemory("memory w=15 memLevel=8 ctx", 15, 8, false);
+    ReportMemory("memory w=10 memLevel=4 ctx", 10, 4, false);
+    ReportMemory("memory no_context_takeover", 15, 8, true);
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include "uv_net.h"
+#include "uv_net/websocket_frame.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <set>
+#include <thread>
+#include <vector>
+#include <poll.h>
+
+using namespace uv_net;
+
+// WebSocket 广播：同一条消息推送给所有连接，对比逐连接 SendBinary（每次编码并拷贝）与共享的 PreparedFrame
+// 用法: ws_fanout_bench [载荷大小] [连接数] [广播轮数]
+
+static const int kWsPort = 7150;
+
+static bool Handshake(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\n"
+        "Host: 127.0.0.1\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n";
+    if (!bench::WriteAll(fd, kRequest, sizeof(kRequest) - 1)) {
+        return false;
+    }
+    // 逐字节读取，不越过响应头（之后的数据计入广播字节数）
+    std::string response;
+    char c;
+    while (response.size() < 4 || response.compare(response.size() - 4, 4, "\r\n\r\n") != 0) {
+        if (recv(fd, &c, 1, 0) != 1) {
+            return false;
+        }
+        response.push_back(c);
+    }
+    return response.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+struct FanoutState {
+    std::set<WebSocketConnection*> conns;
+    std::string payload;
+    int rounds = 0;
+    bool prepared = false;
+    int64_t enqueue_ns = 0;
+};
+
+static void Broadcast(FanoutState& state) {
+    int64_t start = bench::NowNs();
+    if (state.prepared) {
+        PreparedFrame frame(state.payload.data(), state.payload.size());
+        for (int r = 0; r < state.rounds; ++r) {
+            for (WebSocketConnection* conn : state.conns) {
+                conn->SendPrepared(frame);
+            }
+        }
+    } else {
+        for (int r = 0; r < state.rounds; ++r) {
+            for (WebSocketConnection* conn : state.conns) {
+                conn->SendBinary(state.payload.data(), state.payload.size());
+            }
+        }
+    }
+    state.enqueue_ns = bench::NowNs() - start;
+}
+
+// 读取所有客户端连接，直到收到 expected 字节
+static uint64_t Drain(const std::vector<int>& fds, uint64_t expected, int64_t deadline) {
+    std::vector<struct pollfd> pfds(fds.size());
+    for (size_t i = 0; i < fds.size(); ++i) {
+        pfds[i].fd = fds[i];
+        pfds[i].events = POLLIN;
+    }
+    std::vector<char> buf(1 << 16);
+    uint64_t received = 0;
+    while (received < expected && bench::NowNs() < deadline) {
+        if (poll(pfds.data(), pfds.size(), 100) <= 0) {
+            continue;
+        }
+        for (auto& p : pfds) {
+            if (p.revents & POLLIN) {
+                ssize_t n = recv(p.fd, buf.data(), buf.size(), MSG_DONTWAIT);
+                if (n > 0) {
+                    received += static_cast<uint64_t>(n);
+                }
+            }
+        }
+    }
+    return received;
+}
+
+int main(int argc, char** argv) {
+    size_t payload_size = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1024;
+    int connections = argc > 2 ? atoi(argv[2]) : 1000;
+    int rounds = argc > 3 ? atoi(argv[3]) : 100;
+    printf("payload=%zu connections=%d rounds=%d\n", payload_size, connections, rounds);
+
+    FanoutState state;
+    state.payload.assign(payload_size, 'x');
+    state.rounds = rounds;
+
+    uv_async_t broadcast_async;
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+    std::atomic<int> broadcasts{0};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetReadBufferSize(65536);
+        config.SetWriteBufferSize(1 << 20);
+        config.SetMaxSendQueueSize(static_cast<size_t>(rounds) + 16);
+        WebSocketServer server(loop, config);
+        // OnOpen 在握手完成时触发，连接的生命周期由服务器管理
+        server.SetOnOpen([&state](std::shared_ptr<Connection> conn) {
+            state.conns.insert(static_cast<WebSocketConnection*>(conn.get()));
+        });
+        server.SetOnClose([&state](std::shared_ptr<Connection> conn) {
+            state.conns.erase(static_cast<WebSocketConnection*>(conn.get()));
+        });
+
+        if (!server.Start("127.0.0.1", kWsPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        broadcast_async.data = &state;
+        uv_async_init(loop, &broadcast_async, [](uv_async_t* handle) {
+            Broadcast(*static_cast<FanoutState*>(handle->data));
+        });
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&broadcast_async, nullptr);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::vector<int> fds;
+    for (int c = 0; c < connections; ++c) {
+        int fd = bench::Connect("127.0.0.1", kWsPort);
+        if (fd < 0 || !Handshake(fd)) {
+            fprintf(stderr, "handshake failed after %d connections\n", c);
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+    // 等待服务器处理完全部握手
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    char header[kWebSocketMaxHeaderSize];
+    size_t frame_size = EncodeWebSocketFrameHeader(header, true, WebSocketOpcode::BINARY, payload_size) + payload_size;
+    uint64_t expected = static_cast<uint64_t>(connections) * rounds * frame_size;
+
+    for (int mode = 0; mode < 2; ++mode) {
+        state.prepared = mode == 1;
+        int64_t start = bench::NowNs();
+        uv_async_send(&broadcast_async);
+        uint64_t received = Drain(fds, expected, start + 60LL * 1000 * 1000 * 1000);
+        int64_t elapsed = bench::NowNs() - start;
+        if (received != expected) {
+            fprintf(stderr, "received %llu bytes, expected %llu\n", (unsigned long long)received,
+                    (unsigned long long)expected);
+        }
+        uint64_t messages = static_cast<uint64_t>(connections) * rounds;
+        const char* name = state.prepared ? "SendPrepared" : "SendBinary";
+        bench::Report(std::string(name) + " enqueue", messages, messages * payload_size, state.enqueue_ns);
+        bench::Report(std::string(name) + " delivered", messages, received, elapsed);
+    }
+
+    for (int fd : fds) {
+        close(fd);
+    }
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "uv_net.h"
+#include "uv_net/simd.h"
+#include "uv_net/websocket_frame.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// WebSocket 发送分片：大消息排队时 Pong 的等待时间（客户端限速读取，模拟慢速链路），以及不限速时的发送吞吐
+// 用法: ws_fragment_bench [消息大小MB] [客户端读取速率MB/s] [分片大小]
+
+static const int kWsPort = 7161;
+static const uint8_t kKey[4] = {0x12, 0x34, 0x56, 0x78};
+
+// 客户端帧：带掩码
+static void AppendClientFrame(std::string& out, WebSocketOpcode opcode, const char* payload, size_t len) {
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, true, opcode, len);
+    header[1] = static_cast<char>(header[1] | 0x80);
+    out.append(header, header_len);
+    out.append(reinterpret_cast<const char*>(kKey), 4);
+    size_t offset = out.size();
+    out.append(payload, len);
+    MaskBytes(&out[offset], len, kKey);
+}
+
+static bool Handshake(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\n"
+        "Host: 127.0.0.1\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n";
+    if (!bench::WriteAll(fd, kRequest, sizeof(kRequest) - 1)) {
+        return false;
+    }
+    std::string response;
+    char buf[512];
+    while (response.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            return false;
+        }
+        response.append(buf, static_cast<size_t>(n));
+    }
+    return response.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+// 请求服务器以 fragment_size 分片发送一条 message_size 字节的消息，限速读取时 50ms 后发出 Ping
+// rate_mbps 为 0 时不限速读取、不发 Ping，只统计发送耗时；返回是否完整收到
+static bool RunCase(size_t message_size, size_t fragment_size, double rate_mbps) {
+    int fd = bench::Connect("127.0.0.1", kWsPort);
+    if (fd < 0 || !Handshake(fd)) {
+        fprintf(stderr, "handshake failed\n");
+        return false;
+    }
+    std::string request;
+    std::string size = std::to_string(fragment_size);
+    AppendClientFrame(request, WebSocketOpcode::TEXT, size.data(), size.size());
+    int64_t start = bench::NowNs();
+    bench::WriteAll(fd, request.data(), request.size());
+
+    std::vector<char> buffer(256 * 1024);
+    std::string pending;
+    uint64_t skip = 0;        // 当前数据帧尚未读到的载荷
+    uint64_t received = 0;    // 已收到的消息载荷
+    uint64_t fragments = 0;
+    uint64_t read_bytes = 0;
+    int64_t ping_ns = 0;
+    int64_t pong_ns = 0;
+    uint64_t pong_after = 0;  // Pong 到达前已收到的消息字节数
+    int64_t done_ns = 0;
+    while (done_ns == 0 || (rate_mbps > 0 && pong_ns == 0)) {
+        if (rate_mbps > 0 && ping_ns == 0 && (done_ns != 0 || bench::NowNs() - start > 50 * 1000 * 1000)) {
+            std::string ping;
+            AppendClientFrame(ping, WebSocketOpcode::PING, "ping", 4);
+            bench::WriteAll(fd, ping.data(), ping.size());
+            ping_ns = bench::NowNs();
+        }
+        ssize_t n = recv(fd, buffer.data(), buffer.size(), 0);
+        if (n <= 0) {
+            close(fd);
+            return false;
+        }
+        read_bytes += static_cast<uint64_t>(n);
+        const char* p = buffer.data();
+        size_t len = static_cast<size_t>(n);
+        if (skip > 0) {
+            size_t used = skip < len ? static_cast<size_t>(skip) : len;
+            skip -= used;
+            received += used;
+            p += used;
+            len -= used;
+        }
+        pending.append(p, len);
+        while (skip == 0 && !pending.empty()) {
+            WebSocketFrame frame;
+            int header_len = ParseWebSocketFrameHeader(pending.data(), pending.size(), frame);
+            if (header_len <= 0) {
+                break;
+            }
+            if (IsControlOpcode(frame.opcode)) {
+                if (pending.size() < header_len + frame.payload_length) {
+                    break;
+                }
+                if (frame.opcode == WebSocketOpcode::PONG) {
+                    pong_ns = bench::NowNs();
+                    pong_after = received;
+                }
+                pending.erase(0, header_len + static_cast<size_t>(frame.payload_length));
+                continue;
+            }
+            fragments++;
+            size_t used = pending.size() - header_len < frame.payload_length ? pending.size() - header_len
+                                                                             : static_cast<size_t>(frame.payload_length);
+            skip = frame.payload_length - used;
+            received += used;
+            pending.erase(0, header_len + used);
+        }
+        if (done_ns == 0 && received == message_size) {
+            done_ns = bench::NowNs();
+        }
+        // 按速率限速：读到的字节数超前于时间时休眠
+        if (rate_mbps > 0) {
+            int64_t due = start + static_cast<int64_t>(read_bytes / (rate_mbps * 1024 * 1024) * 1e9);
+            int64_t now = bench::NowNs();
+            if (due > now) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+            }
+        }
+    }
+    close(fd);
+
+    char name[64];
+    snprintf(name, sizeof(name), "fragment=%zu%s", fragment_size, fragment_size == 0 ? " (off)" : "");
+    if (rate_mbps > 0) {
+        printf("%-24s pong after %8.1f ms (%6.1f MB of the message ahead)  frames=%llu\n", name,
+               (pong_ns - ping_ns) / 1e6, pong_after / (1024.0 * 1024.0), (unsigned long long)fragments);
+    } else {
+        bench::Report(std::string("send ") + name, 1, message_size, done_ns - start);
+    }
+    fflush(stdout);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t message_mb = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 20;
+    double rate_mbps = argc > 2 ? atof(argv[2]) : 50;
+    size_t fragment_size = argc > 3 ? static_cast<size_t>(atol(argv[3])) : 64 * 1024;
+    size_t message_size = message_mb * 1024 * 1024;
+    printf("message=%zuMB client_rate=%.0fMB/s\n", message_mb, rate_mbps);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+    std::string message(message_size, 'x');
+
+    // 服务器运行在独立线程的默认loop上；请求消息的内容为本次使用的分片大小
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        // 默认 8KB 的发送缓冲区在回环上会受延迟确认拖慢，这里使用常见的服务器取值
+        ServerConfig config;
+        config.SetWriteBufferSize(256 * 1024);
+        WebSocketServer server(loop, config);
+        server.SetOnMessage([&server, &message](std::shared_ptr<Connection> conn, const char* data, size_t len) {
+            server.SetFragmentSize(static_cast<size_t>(atol(std::string(data, len).c_str())));
+            static_cast<WebSocketConnection*>(conn.get())->SendBinary(message.data(), message.size());
+        });
+
+        if (!server.Start("127.0.0.1", kWsPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    const size_t fragment_sizes[] = {0, fragment_size};
+    for (size_t size : fragment_sizes) {
+        if (!RunCase(message_size, size, rate_mbps)) {
+            fprintf(stderr, "fragment=%zu failed\n", size);
+            return 1;
+        }
+    }
+    for (size_t size : fragment_sizes) {
+        for (int i = 0; i < 3; ++i) {
+            if (!RunCase(message_size, size, 0)) {
+                fprintf(stderr, "fragment=%zu failed\n", size);
+                return 1;
+            }
+        }
+    }
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
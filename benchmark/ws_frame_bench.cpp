@@ -0,0 +1,177 @@
+#include "uv_net.h"
+#include "uv_net/simd.h"
+#include "uv_net/websocket_frame.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// WebSocket 小帧吞吐：帧解析本身，以及多个小帧合并在一次读取中到达时 WebSocketServer 的处理速度
+// 用法: ws_frame_bench [载荷大小] [连接数] [每次写入的帧数] [每连接写入次数]
+
+static const int kWsPort = 7140;
+static const uint8_t kKey[4] = {0x12, 0x34, 0x56, 0x78};
+
+// 客户端帧：带掩码
+static void AppendClientFrame(std::string& out, const std::string& payload) {
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, true, WebSocketOpcode::TEXT, payload.size());
+    header[1] = static_cast<char>(header[1] | 0x80);
+    out.append(header, header_len);
+    out.append(reinterpret_cast<const char*>(kKey), 4);
+    size_t offset = out.size();
+    out.append(payload);
+    MaskBytes(&out[offset], payload.size(), kKey);
+}
+
+static void BenchParser(const std::string& frames, size_t frame_count, int rounds) {
+    std::vector<char> buffer(frames.size());
+    uint64_t parsed = 0;
+    uint64_t bytes = 0;
+    int64_t start = bench::NowNs();
+    for (int r = 0; r < rounds; ++r) {
+        // 每轮重新拷入，模拟一次读取的数据（解掩码为原地修改）
+        memcpy(buffer.data(), frames.data(), frames.size());
+        char* data = buffer.data();
+        size_t len = buffer.size();
+        size_t pos = 0;
+        while (pos < len) {
+            WebSocketFrame frame;
+            int header_len = ParseWebSocketFrameHeader(data + pos, len - pos, frame);
+            if (header_len <= 0 || len - pos - header_len < frame.payload_length) {
+                break;
+            }
+            frame.payload = data + pos + header_len;
+            MaskBytes(frame.payload, static_cast<size_t>(frame.payload_length), frame.masking_key);
+            bench::DoNotOptimize(frame.payload[0]);
+            pos += header_len + static_cast<size_t>(frame.payload_length);
+            bytes += frame.payload_length;
+            parsed++;
+        }
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    if (parsed != frame_count * rounds) {
+        fprintf(stderr, "parsed %llu frames, expected %llu\n", (unsigned long long)parsed,
+                (unsigned long long)(frame_count * rounds));
+    }
+    bench::Report("ParseWebSocketFrameHeader + MaskBytes", parsed, bytes, elapsed);
+}
+
+static bool Handshake(int fd) {
+    static const char kRequest[] =
+        "GET / HTTP/1.1\r\n"
+        "Host: 127.0.0.1\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n";
+    if (!bench::WriteAll(fd, kRequest, sizeof(kRequest) - 1)) {
+        return false;
+    }
+    std::string response;
+    char buf[512];
+    while (response.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            return false;
+        }
+        response.append(buf, static_cast<size_t>(n));
+    }
+    return response.compare(0, 12, "HTTP/1.1 101") == 0;
+}
+
+int main(int argc, char** argv) {
+    size_t payload_size = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 32;
+    int connections = argc > 2 ? atoi(argv[2]) : 4;
+    int frames_per_write = argc > 3 ? atoi(argv[3]) : 64;
+    int writes = argc > 4 ? atoi(argv[4]) : 20000;
+
+    std::string payload(payload_size, 'x');
+    std::string batch;
+    for (int i = 0; i < frames_per_write; ++i) {
+        AppendClientFrame(batch, payload);
+    }
+    printf("payload=%zu connections=%d frames_per_write=%d writes=%d write_size=%zu\n",
+           payload_size, connections, frames_per_write, writes, batch.size());
+
+    BenchParser(batch, static_cast<size_t>(frames_per_write), 200000);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+    std::atomic<uint64_t> received{0};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetReadBufferSize(65536);
+        WebSocketServer server(loop, config);
+        server.SetOnMessage([&received](std::shared_ptr<Connection> conn, const char* data, size_t len) {
+            received.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        if (!server.Start("127.0.0.1", kWsPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::vector<int> fds;
+    for (int c = 0; c < connections; ++c) {
+        int fd = bench::Connect("127.0.0.1", kWsPort);
+        if (fd < 0 || !Handshake(fd)) {
+            fprintf(stderr, "handshake failed\n");
+            return 1;
+        }
+        fds.push_back(fd);
+    }
+
+    uint64_t expected = static_cast<uint64_t>(connections) * frames_per_write * writes;
+    std::vector<std::thread> clients;
+    int64_t start = bench::NowNs();
+    for (int fd : fds) {
+        clients.emplace_back([&batch, fd, writes]() {
+            for (int i = 0; i < writes; ++i) {
+                if (!bench::WriteAll(fd, batch.data(), batch.size())) {
+                    break;
+                }
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    int64_t deadline = bench::NowNs() + 30LL * 1000 * 1000 * 1000;
+    while (received.load() < expected && bench::NowNs() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    if (received.load() != expected) {
+        fprintf(stderr, "received %llu messages, expected %llu\n", (unsigned long long)received.load(),
+                (unsigned long long)expected);
+    }
+    bench::Report("WebSocketServer small frames", received.load(), received.load() * payload_size, elapsed);
+
+    for (int fd : fds) {
+        close(fd);
+    }
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
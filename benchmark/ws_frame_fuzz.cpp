@@ -0,0 +1,484 @@
+#include "uv_net.h"
+#include "uv_net/simd.h"
+#include "uv_net/websocket_frame.h"
+#include "bench_util.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include <sys/time.h>
+
+using namespace uv_net;
+
+// WebSocket 帧解析回归校验（由随机客户端测试整理出的用例），结果不符时返回非零
+// - 固定种子的随机帧流：0-9000 字节载荷、分片消息、穿插 Ping，按随机边界切分写入，首段与握手请求一起发出
+// - 每种协议违规（未加掩码、保留操作码/RSV、控制帧分片或超长、分片顺序错误、超长消息、非法 UTF-8）
+//   都必须以对应的关闭码关闭连接，违规之前的消息照常回显
+// - 握手后的随机垃圾数据不能使服务器崩溃，之后的连接照常工作
+// 用法: ws_frame_fuzz [种子] [随机轮数]
+
+static const int kWsPort = 7145;
+static const int kRecvTimeoutMs = 5000;
+
+static std::mt19937 rng;
+
+static size_t Random(size_t lo, size_t hi) {
+    return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+}
+
+static std::string RandomBytes(size_t len) {
+    std::string out(len, '\0');
+    for (size_t i = 0; i < len; ++i) {
+        out[i] = static_cast<char>(Random(0, 255));
+    }
+    return out;
+}
+
+static std::string RandomText(size_t len) {
+    std::string out(len, '\0');
+    for (size_t i = 0; i < len; ++i) {
+        out[i] = static_cast<char>(Random(0x20, 0x7E));
+    }
+    return out;
+}
+
+// 载荷大小：多数为小帧，部分跨越 126 与 65536 之外的中等长度，最大 9000 字节（大于默认 8KB 读缓冲区）
+static size_t RandomPayloadSize() {
+    size_t kind = Random(0, 99);
+    if (kind < 60) {
+        return Random(0, 125);
+    }
+    if (kind < 85) {
+        return Random(126, 2000);
+    }
+    return Random(2001, 9000);
+}
+
+// 客户端帧：随机掩码键，masked 为 false 时构造未加掩码的违规帧
+static void AppendClientFrame(std::string& out, bool fin, uint8_t opcode, const std::string& payload,
+                              uint8_t rsv = 0, bool masked = true) {
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, fin, static_cast<WebSocketOpcode>(opcode), payload.size(), rsv);
+    if (masked) {
+        header[1] = static_cast<char>(header[1] | 0x80);
+    }
+    out.append(header, header_len);
+    size_t offset = out.size();
+    if (masked) {
+        uint8_t key[4];
+        for (uint8_t& k : key) {
+            k = static_cast<uint8_t>(Random(0, 255));
+        }
+        out.append(reinterpret_cast<const char*>(key), 4);
+        offset = out.size();
+        out.append(payload);
+        MaskBytes(&out[offset], payload.size(), key);
+    } else {
+        out.append(payload);
+    }
+}
+
+static std::string CloseFrame(uint16_t code) {
+    std::string payload(2, '\0');
+    payload[0] = static_cast<char>(code >> 8);
+    payload[1] = static_cast<char>(code & 0xFF);
+    std::string out;
+    AppendClientFrame(out, true, 0x8, payload);
+    return out;
+}
+
+static const char kHandshakeRequest[] =
+    "GET / HTTP/1.1\r\n"
+    "Host: 127.0.0.1\r\n"
+    "Upgrade: websocket\r\n"
+    "Connection: Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "Sec-WebSocket-Version: 13\r\n"
+    "\r\n";
+
+// 按随机边界切分写入，偶尔停顿让服务器在边界处分次读取
+static bool WriteSplit(int fd, const std::string& data) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t chunk = Random(0, 3) == 0 ? Random(1, 16) : Random(1, 12000);
+        chunk = std::min(chunk, data.size() - pos);
+        if (!bench::WriteAll(fd, data.data() + pos, chunk)) {
+            return false;
+        }
+        pos += chunk;
+        if (Random(0, 7) == 0) {
+            usleep(200);
+        }
+    }
+    return true;
+}
+
+// 服务端帧读取（不带掩码），跳过握手应答
+class FrameReader {
+public:
+    explicit FrameReader(int fd) : fd_(fd), handshake_done_(false), eof_(false) {}
+
+    // 读取一个完整帧；连接关闭或超时返回 false
+    bool Read(WebSocketFrame& frame, std::string& payload) {
+        for (;;) {
+            if (!handshake_done_) {
+                size_t end = buffer_.find("\r\n\r\n");
+                if (end != std::string::npos) {
+                    if (buffer_.compare(0, 12, "HTTP/1.1 101") != 0) {
+                        return false;
+                    }
+                    buffer_.erase(0, end + 4);
+                    handshake_done_ = true;
+                    continue;
+                }
+            } else {
+                int header_len = ParseWebSocketFrameHeader(buffer_.data(), buffer_.size(), frame);
+                if (header_len < 0) {
+                    return false;
+                }
+                if (header_len > 0 && buffer_.size() - header_len >= frame.payload_length) {
+                    payload.assign(buffer_, static_cast<size_t>(header_len), static_cast<size_t>(frame.payload_length));
+                    buffer_.erase(0, header_len + static_cast<size_t>(frame.payload_length));
+                    return true;
+                }
+            }
+            if (!Fill()) {
+                return false;
+            }
+        }
+    }
+
+    // 对端是否已关闭连接（之前不应再有数据）；服务器关闭时还有未读的数据会收到 RST，同样视为关闭
+    bool AtEof() {
+        return buffer_.empty() && !Fill() && eof_;
+    }
+
+private:
+    bool Fill() {
+        char buf[16384];
+        ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+        eof_ = n == 0 || (n < 0 && errno == ECONNRESET);
+        if (n <= 0) {
+            return false;
+        }
+        buffer_.append(buf, static_cast<size_t>(n));
+        return true;
+    }
+
+    int fd_;
+    bool handshake_done_;
+    bool eof_;
+    std::string buffer_;
+};
+
+static int Connect() {
+    int fd = bench::Connect("127.0.0.1", kWsPort);
+    if (fd >= 0) {
+        struct timeval tv;
+        tv.tv_sec = kRecvTimeoutMs / 1000;
+        tv.tv_usec = (kRecvTimeoutMs % 1000) * 1000;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    return fd;
+}
+
+// 读取回显消息与 Pong，直到收到 close 帧；返回 close 帧中的关闭码，连接异常时返回 0
+static uint16_t ReadUntilClose(FrameReader& reader, std::vector<std::string>& messages, std::vector<std::string>& pongs) {
+    std::string message;
+    WebSocketFrame frame;
+    std::string payload;
+    while (reader.Read(frame, payload)) {
+        switch (frame.opcode) {
+            case WebSocketOpcode::TEXT:
+            case WebSocketOpcode::BINARY:
+            case WebSocketOpcode::CONTINUATION:
+                message += payload;
+                if (frame.fin) {
+                    messages.push_back(std::move(message));
+                    message.clear();
+                }
+                break;
+            case WebSocketOpcode::PONG:
+                pongs.push_back(payload);
+                break;
+            case WebSocketOpcode::CLOSE:
+                if (payload.size() < 2) {
+                    return 0;
+                }
+                return static_cast<uint16_t>((static_cast<uint8_t>(payload[0]) << 8) | static_cast<uint8_t>(payload[1]));
+            case WebSocketOpcode::PING:
+                break;
+        }
+    }
+    return 0;
+}
+
+static bool Expect(bool ok, const char* what, int round) {
+    if (!ok) {
+        fprintf(stderr, "round %d: %s\n", round, what);
+    }
+    return ok;
+}
+
+// 随机帧流：全部消息按序回显、每个 Ping 得到 Pong，最后以 1000 正常关闭
+static bool CheckRandomStream(int round) {
+    std::string stream(kHandshakeRequest, sizeof(kHandshakeRequest) - 1);
+    std::vector<std::string> expected_messages;
+    std::vector<std::string> expected_pongs;
+
+    size_t message_count = Random(1, 40);
+    for (size_t m = 0; m < message_count; ++m) {
+        bool text = Random(0, 1) == 0;
+        std::string message = text ? RandomText(RandomPayloadSize()) : RandomBytes(RandomPayloadSize());
+        size_t fragments = Random(0, 9) < 3 ? Random(2, 4) : 1;
+        size_t offset = 0;
+        for (size_t f = 0; f < fragments; ++f) {
+            if (Random(0, 4) == 0) {
+                std::string ping = RandomBytes(Random(0, 125));
+                AppendClientFrame(stream, true, 0x9, ping);
+                expected_pongs.push_back(ping);
+            }
+            bool last = f + 1 == fragments;
+            size_t len = last ? message.size() - offset : Random(0, message.size() - offset);
+            uint8_t opcode = f > 0 ? 0x0 : (text ? 0x1 : 0x2);
+            AppendClientFrame(stream, last, opcode, message.substr(offset, len));
+            offset += len;
+        }
+        expected_messages.push_back(std::move(message));
+    }
+    stream += CloseFrame(1000);
+
+    int fd = Connect();
+    if (!Expect(fd >= 0, "connect failed", round)) {
+        return false;
+    }
+    bool ok = Expect(WriteSplit(fd, stream), "write failed", round);
+    FrameReader reader(fd);
+    std::vector<std::string> messages;
+    std::vector<std::string> pongs;
+    uint16_t code = ok ? ReadUntilClose(reader, messages, pongs) : 0;
+    ok = ok && Expect(messages == expected_messages, "echoed messages mismatch", round) &&
+         Expect(pongs == expected_pongs, "pongs mismatch", round) &&
+         Expect(code == 1000, "close code mismatch", round) &&
+         Expect(reader.AtEof(), "connection not closed after close frame", round);
+    close(fd);
+    return ok;
+}
+
+struct ViolationCase {
+    const char* name;
+    uint16_t code;
+    std::string (*build)();
+};
+
+static std::string Unmasked() {
+    std::string out;
+    AppendClientFrame(out, true, 0x2, "payload", 0, false);
+    return out;
+}
+
+static std::string ReservedOpcode() {
+    std::string out;
+    AppendClientFrame(out, true, 0x3, "payload");
+    return out;
+}
+
+static std::string ReservedControlOpcode() {
+    std::string out;
+    AppendClientFrame(out, true, 0xB, "payload");
+    return out;
+}
+
+static std::string Rsv1WithoutExtension() {
+    std::string out;
+    AppendClientFrame(out, true, 0x2, "payload", 0x4);
+    return out;
+}
+
+static std::string Rsv3() {
+    std::string out;
+    AppendClientFrame(out, true, 0x2, "payload", 0x1);
+    return out;
+}
+
+static std::string FragmentedPing() {
+    std::string out;
+    AppendClientFrame(out, false, 0x9, "ping");
+    return out;
+}
+
+static std::string LongPing() {
+    std::string out;
+    AppendClientFrame(out, true, 0x9, std::string(126, 'p'));
+    return out;
+}
+
+static std::string ContinuationWithoutStart() {
+    std::string out;
+    AppendClientFrame(out, true, 0x0, "payload");
+    return out;
+}
+
+static std::string NewMessageInsideFragmented() {
+    std::string out;
+    AppendClientFrame(out, false, 0x2, "first");
+    AppendClientFrame(out, true, 0x2, "second");
+    return out;
+}
+
+static std::string TooLarge() {
+    // 只发出帧头与部分载荷，服务器应在帧头到达时即拒绝
+    std::string out;
+    AppendClientFrame(out, true, 0x2, std::string(70000, 'x'));
+    out.resize(out.size() - 60000);
+    return out;
+}
+
+static std::string FragmentedTooLarge() {
+    std::string out;
+    AppendClientFrame(out, false, 0x2, std::string(40000, 'x'));
+    AppendClientFrame(out, true, 0x0, std::string(30000, 'y'));
+    return out;
+}
+
+static std::string InvalidUtf8() {
+    std::string out;
+    AppendClientFrame(out, true, 0x1, "bad \xC0\xAF utf8");
+    return out;
+}
+
+static std::string InvalidUtf8AcrossFragments() {
+    std::string out;
+    AppendClientFrame(out, false, 0x1, "ok \xE4\xB8");
+    AppendClientFrame(out, true, 0x0, "\x41 bad");
+    return out;
+}
+
+static const ViolationCase kViolations[] = {
+    {"unmasked frame", 1002, Unmasked},
+    {"reserved data opcode", 1002, ReservedOpcode},
+    {"reserved control opcode", 1002, ReservedControlOpcode},
+    {"RSV1 without permessage-deflate", 1002, Rsv1WithoutExtension},
+    {"RSV3", 1002, Rsv3},
+    {"fragmented ping", 1002, FragmentedPing},
+    {"ping longer than 125 bytes", 1002, LongPing},
+    {"continuation without start", 1002, ContinuationWithoutStart},
+    {"new message inside fragmented message", 1002, NewMessageInsideFragmented},
+    {"frame larger than max package size", 1009, TooLarge},
+    {"fragments larger than max package size", 1009, FragmentedTooLarge},
+    {"invalid UTF-8", 1007, InvalidUtf8},
+    {"invalid UTF-8 across fragments", 1007, InvalidUtf8AcrossFragments},
+};
+
+// 违规用例：之前的合法消息照常回显，随后收到对应关闭码的 close 帧并断开
+static bool CheckViolation(const ViolationCase& violation, int round) {
+    std::string stream(kHandshakeRequest, sizeof(kHandshakeRequest) - 1);
+    std::vector<std::string> expected_messages;
+    size_t valid_count = Random(0, 3);
+    for (size_t i = 0; i < valid_count; ++i) {
+        std::string message = RandomBytes(RandomPayloadSize());
+        AppendClientFrame(stream, true, 0x2, message);
+        expected_messages.push_back(std::move(message));
+    }
+    stream += violation.build();
+
+    int fd = Connect();
+    if (!Expect(fd >= 0, "connect failed", round)) {
+        return false;
+    }
+    // 服务器拒绝后立即关闭，之后的写入可能失败
+    WriteSplit(fd, stream);
+    FrameReader reader(fd);
+    std::vector<std::string> messages;
+    std::vector<std::string> pongs;
+    uint16_t code = ReadUntilClose(reader, messages, pongs);
+    bool ok = messages == expected_messages && code == violation.code && reader.AtEof();
+    if (!ok) {
+        fprintf(stderr, "round %d: %s: expected close %u after %zu messages, got close %u after %zu messages\n",
+                round, violation.name, violation.code, expected_messages.size(), code, messages.size());
+    }
+    close(fd);
+    return ok;
+}
+
+// 随机垃圾：写完后半关闭，服务器必须结束连接（协议错误或对端关闭）
+static bool CheckGarbage(int round) {
+    std::string stream(kHandshakeRequest, sizeof(kHandshakeRequest) - 1);
+    stream += RandomBytes(Random(1, 512));
+
+    int fd = Connect();
+    if (!Expect(fd >= 0, "connect failed", round)) {
+        return false;
+    }
+    WriteSplit(fd, stream);
+    shutdown(fd, SHUT_WR);
+    // 垃圾中可能恰好含有合法帧，丢弃回显，只要求连接在超时前结束
+    char buf[16384];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    }
+    bool ok = Expect(n == 0 || errno == ECONNRESET, "connection not closed after garbage", round);
+    close(fd);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = argc > 1 ? static_cast<unsigned>(atol(argv[1])) : 20260418;
+    int rounds = argc > 2 ? atoi(argv[2]) : 50;
+    rng.seed(seed);
+    printf("seed=%u rounds=%d\n", seed, rounds);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop），回显收到的每条消息
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        WebSocketServer server(loop);
+        server.SetPingEnabled(false);
+        server.SetOnMessage([](std::shared_ptr<Connection> conn, const char* data, size_t len) {
+            std::static_pointer_cast<WebSocketConnection>(conn)->SendBinary(data, len);
+        });
+
+        if (!server.Start("127.0.0.1", kWsPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    int failures = 0;
+    for (int round = 0; round < rounds; ++round) {
+        failures += CheckRandomStream(round) ? 0 : 1;
+        for (const ViolationCase& violation : kViolations) {
+            failures += CheckViolation(violation, round) ? 0 : 1;
+        }
+        failures += CheckGarbage(round) ? 0 : 1;
+    }
+    // 所有用例之后服务器仍然可用
+    failures += CheckRandomStream(rounds) ? 0 : 1;
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "uv_net.h"
+#include "uv_net/websocket_handshake.h"
+#include "bench_util.h"
+#include <openssl/sha.h>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace uv_net;
+
+// WebSocket 握手：请求解析与应答生成的耗时，以及 WebSocketServer 每秒完成的握手数（模拟大量客户端重连）
+// 用法: ws_handshake_bench [客户端线程数] [每线程握手次数]
+
+static const int kWsPort = 7160;
+
+// 浏览器发出的典型升级请求
+static const char kRequest[] =
+    "GET /chat?room=lobby HTTP/1.1\r\n"
+    "Host: 127.0.0.1:7160\r\n"
+    "Connection: Upgrade\r\n"
+    "Pragma: no-cache\r\n"
+    "Cache-Control: no-cache\r\n"
+    "User-Agent: Mozilla/5.0 (Linux; Android 14) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0 Mobile Safari/537.36\r\n"
+    "Upgrade: websocket\r\n"
+    "Origin: https://example.com\r\n"
+    "Sec-WebSocket-Version: 13\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+    "\r\n";
+
+// 改写前的做法：查找子串、拼接临时字符串、一次性 SHA1、逐字符 Base64
+static std::string LegacyHandshake(const std::string& request) {
+    size_t key_pos = request.find("Sec-WebSocket-Key: ");
+    size_t key_end = request.find("\r\n", key_pos);
+    std::string key = request.substr(key_pos + 19, key_end - (key_pos + 19));
+    std::string combined = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char hash[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(combined.c_str()), combined.size(), hash);
+
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string accept;
+    int val = 0;
+    int valb = -6;
+    for (size_t i = 0; i < SHA_DIGEST_LENGTH; ++i) {
+        val = (val << 8) + hash[i];
+        valb += 8;
+        while (valb >= 0) {
+            accept += chars[(val >> valb) & 0x3F];
+            valb -= 6;
+        }
+    }
+    if (valb > -6) {
+        accept += chars[((val << 8) >> (valb + 8)) & 0x3F];
+    }
+    while (accept.size() % 4) {
+        accept += '=';
+    }
+
+    std::string response = "HTTP/1.1 101 Switching Protocols\r\n";
+    response += "Upgrade: websocket\r\n";
+    response += "Connection: Upgrade\r\n";
+    response += "Sec-WebSocket-Accept: " + accept + "\r\n\r\n";
+    return response;
+}
+
+static void BenchParse(int rounds) {
+    std::vector<char> buffer(kRequest, kRequest + sizeof(kRequest) - 1);
+    std::string request(kRequest, sizeof(kRequest) - 1);
+    std::vector<std::string> subprotocols;
+
+    int64_t start = bench::NowNs();
+    for (int i = 0; i < rounds; ++i) {
+        buffer[0] = 'G'; // 避免循环被提到外面
+        std::string legacy = LegacyHandshake(std::string(buffer.begin(), buffer.end()));
+        bench::DoNotOptimize(legacy[0]);
+    }
+    bench::Report("legacy find + SHA1 + string", rounds, rounds * request.size(), bench::NowNs() - start);
+
+    std::string expected = LegacyHandshake(request);
+    start = bench::NowNs();
+    for (int i = 0; i < rounds; ++i) {
+        buffer[0] = 'G';
+        WebSocketUpgradeRequest upgrade;
+        size_t head_len = HttpParser::FindHeadEnd(buffer.data(), buffer.size(), 0);
+        if (ParseWebSocketUpgrade(buffer.data(), head_len, upgrade) != 0) {
+            fprintf(stderr, "upgrade request rejected\n");
+            exit(1);
+        }
+        char accept[kWebSocketAcceptSize];
+        ComputeWebSocketAccept(upgrade.key, accept);
+        char response[kWebSocketMaxResponseSize];
+        size_t len = BuildWebSocketHandshakeResponse(response, sizeof(response), accept,
+                                                     SelectWebSocketProtocol(upgrade.protocols, subprotocols),
+                                                     StringView());
+        if (i == 0 && expected != std::string(response, len)) {
+            fprintf(stderr, "response mismatch\n");
+            exit(1);
+        }
+        bench::DoNotOptimize(response[0]);
+    }
+    bench::Report("ParseWebSocketUpgrade + stack response", rounds, rounds * request.size(), bench::NowNs() - start);
+}
+
+// 一次完整的握手：连接、发送升级请求、读到 101 响应头后以 RST 断开（不留 TIME_WAIT）
+static bool HandshakeOnce() {
+    int fd = bench::Connect("127.0.0.1", kWsPort);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = bench::WriteAll(fd, kRequest, sizeof(kRequest) - 1);
+    std::string response;
+    char buf[512];
+    while (ok && response.find("\r\n\r\n") == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            ok = false;
+            break;
+        }
+        response.append(buf, static_cast<size_t>(n));
+    }
+    ok = ok && response.compare(0, 12, "HTTP/1.1 101") == 0;
+    struct linger lg = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+    close(fd);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    int per_thread = argc > 2 ? atoi(argv[2]) : 5000;
+    printf("threads=%d handshakes_per_thread=%d\n", threads, per_thread);
+
+    BenchParse(500000);
+
+    uv_async_t stop_async;
+    std::atomic<bool> ready{false};
+
+    // 服务器运行在独立线程的默认loop上（连接心跳定时器使用默认loop）
+    std::thread server_thread([&]() {
+        uv_loop_t* loop = uv_default_loop();
+
+        ServerConfig config;
+        config.SetMaxConnections(static_cast<size_t>(threads) * per_thread * 2 + 1024);
+        WebSocketServer server(loop, config);
+
+        if (!server.Start("127.0.0.1", kWsPort)) {
+            fprintf(stderr, "server start failed\n");
+            exit(1);
+        }
+
+        uv_async_init(loop, &stop_async, [](uv_async_t* handle) {
+            uv_stop(handle->loop);
+        });
+        ready = true;
+        uv_run(loop, UV_RUN_DEFAULT);
+        uv_close((uv_handle_t*)&stop_async, nullptr);
+    });
+
+    while (!ready) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::atomic<uint64_t> completed{0};
+    std::vector<std::thread> clients;
+    int64_t start = bench::NowNs();
+    for (int t = 0; t < threads; ++t) {
+        clients.emplace_back([&completed, per_thread]() {
+            for (int i = 0; i < per_thread; ++i) {
+                if (!HandshakeOnce()) {
+                    fprintf(stderr, "handshake failed\n");
+                    return;
+                }
+                completed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::Report("WebSocketServer handshakes", completed.load(), completed.load() * (sizeof(kRequest) - 1), elapsed);
+
+    uv_async_send(&stop_async);
+    server_thread.join();
+    return 0;
+}
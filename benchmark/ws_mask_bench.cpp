@@ -0,0 +1,84 @@
+#include "uv_net/simd.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace uv_net;
+
+// WebSocket 解掩码：原来的逐字节 i % 4 循环与 64位/SSE2/AVX2 实现对比
+// 用法: ws_mask_bench [总数据量MB]
+
+static const uint8_t kKey[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+// 原 ParseFrame 中的实现，作为基准
+static void MaskBytesByteLoop(char* data, size_t len, const uint8_t key[4]) {
+    for (size_t i = 0; i < len; ++i) {
+        data[i] ^= key[i % 4];
+    }
+}
+
+// 与逐字节实现比对结果，覆盖不同的起始对齐、长度和 offset
+static bool Verify(SimdLevel level) {
+    std::vector<char> expect(1200);
+    std::vector<char> actual(1200);
+    for (size_t align = 0; align < 33; ++align) {
+        for (size_t len = 0; len < 600; len += (len < 80 ? 1 : 37)) {
+            for (size_t offset = 0; offset < 4; ++offset) {
+                for (size_t i = 0; i < len; ++i) {
+                    expect[align + i] = actual[align + i] = static_cast<char>(i * 131 + align);
+                }
+                for (size_t i = 0; i < len; ++i) {
+                    expect[align + i] ^= kKey[(offset + i) % 4];
+                }
+                MaskBytes(level, actual.data() + align, len, kKey, offset);
+                if (memcmp(expect.data() + align, actual.data() + align, len) != 0) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+static void Bench(const std::string& name, size_t frame_size, size_t total, Fn fn) {
+    // 帧从缓冲区的奇数偏移开始，模拟帧头之后的载荷位置
+    std::vector<char> buffer(frame_size + 64, 'x');
+    char* payload = buffer.data() + 6;
+    size_t frames = total / frame_size;
+    int64_t start = bench::NowNs();
+    for (size_t i = 0; i < frames; ++i) {
+        fn(payload, frame_size);
+        bench::DoNotOptimize(payload[0]);
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::Report(name + " " + std::to_string(frame_size) + "B", frames, frames * frame_size, elapsed);
+}
+
+int main(int argc, char** argv) {
+    size_t total_mb = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1024;
+    size_t total = total_mb * 1024 * 1024;
+    printf("data=%zuMB cpu=%s\n", total_mb, SimdLevelName(GetSimdLevel()));
+
+    const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+    for (SimdLevel level : levels) {
+        if (!Verify(level)) {
+            fprintf(stderr, "MaskBytes (%s) mismatch\n", SimdLevelName(level));
+            return 1;
+        }
+    }
+
+    const size_t sizes[] = {64, 1024, 16384, 1024 * 1024};
+    for (size_t size : sizes) {
+        Bench("byte loop (i % 4)", size, total, [](char* data, size_t len) {
+            MaskBytesByteLoop(data, len, kKey);
+        });
+        for (SimdLevel level : levels) {
+            Bench(std::string("MaskBytes (") + SimdLevelName(level) + ")", size, total, [level](char* data, size_t len) {
+                MaskBytes(level, data, len, kKey);
+            });
+        }
+    }
+    return 0;
+}
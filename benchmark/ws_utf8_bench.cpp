@@ -0,0 +1,176 @@
+#include "uv_net/simd.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace uv_net;
+
+// WebSocket 文本帧 UTF-8 校验：逐字符解码的实现与 SCALAR/SSE4.2/AVX2 对比，数据为 ASCII JSON、中文、emoji
+// 用法: ws_utf8_bench [总数据量MB]
+
+// 常见的逐字符解码实现，作为基准和正确性参照
+static bool ValidateUtf8Decode(const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+    while (i < len) {
+        uint32_t cp = s[i];
+        size_t n;
+        uint32_t min;
+        if (cp < 0x80) {
+            ++i;
+            continue;
+        } else if ((cp & 0xE0) == 0xC0) {
+            n = 2;
+            cp &= 0x1F;
+            min = 0x80;
+        } else if ((cp & 0xF0) == 0xE0) {
+            n = 3;
+            cp &= 0x0F;
+            min = 0x800;
+        } else if ((cp & 0xF8) == 0xF0) {
+            n = 4;
+            cp &= 0x07;
+            min = 0x10000;
+        } else {
+            return false;
+        }
+        if (i + n > len) {
+            return false;
+        }
+        for (size_t k = 1; k < n; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+static std::string Repeat(const std::string& unit, size_t size) {
+    std::string out;
+    while (out.size() + unit.size() <= size) {
+        out += unit;
+    }
+    while (out.size() < size) {
+        out += ' ';
+    }
+    return out;
+}
+
+// 随机码点拼接，再随机改写字节制造各种错误，与参照实现比对；另外把数据随机切成多段验证 Utf8Validator
+static bool Verify(SimdLevel level) {
+    static const uint32_t kRanges[][2] = {
+        {0x20, 0x7E}, {0x80, 0x7FF}, {0x800, 0xD7FF}, {0xE000, 0xFFFF}, {0x10000, 0x10FFFF}};
+    srand(12345);
+    for (int round = 0; round < 20000; ++round) {
+        std::string text;
+        size_t chars = static_cast<size_t>(rand() % 200);
+        int mix = rand() % 5;
+        for (size_t i = 0; i < chars; ++i) {
+            const uint32_t* r = kRanges[(rand() % 4 == 0) ? rand() % 5 : mix];
+            uint32_t cp = r[0] + static_cast<uint32_t>(rand()) % (r[1] - r[0] + 1);
+            if (cp < 0x80) {
+                text += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                text += static_cast<char>(0xC0 | (cp >> 6));
+                text += static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                text += static_cast<char>(0xE0 | (cp >> 12));
+                text += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                text += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                text += static_cast<char>(0xF0 | (cp >> 18));
+                text += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                text += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                text += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+        int mutations = round % 3 == 0 ? 0 : rand() % 3 + 1;
+        for (int m = 0; m < mutations && !text.empty(); ++m) {
+            text[static_cast<size_t>(rand()) % text.size()] = static_cast<char>(rand());
+        }
+        if (round % 7 == 0 && !text.empty()) {
+            text.resize(static_cast<size_t>(rand()) % text.size());
+        }
+
+        bool expect = ValidateUtf8Decode(text.data(), text.size());
+        if (ValidateUtf8(level, text.data(), text.size()) != expect) {
+            return false;
+        }
+        Utf8Validator validator;
+        bool ok = true;
+        size_t pos = 0;
+        while (pos < text.size() && ok) {
+            size_t n = static_cast<size_t>(rand()) % 70;
+            if (n > text.size() - pos) {
+                n = text.size() - pos;
+            }
+            ok = validator.Update(text.data() + pos, n);
+            pos += n;
+        }
+        if ((ok && validator.Finish()) != expect) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+static void Bench(const std::string& name, const std::string& text, size_t total, Fn fn) {
+    size_t rounds = total / text.size();
+    int64_t start = bench::NowNs();
+    for (size_t i = 0; i < rounds; ++i) {
+        bool ok = fn(text.data(), text.size());
+        bench::DoNotOptimize(ok);
+    }
+    int64_t elapsed = bench::NowNs() - start;
+    bench::Report(name + " " + std::to_string(text.size()) + "B", rounds, rounds * text.size(), elapsed);
+}
+
+int main(int argc, char** argv) {
+    size_t total_mb = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 512;
+    size_t total = total_mb * 1024 * 1024;
+    printf("data=%zuMB cpu=%s\n", total_mb, SimdLevelName(GetSimdLevel()));
+
+    const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2};
+    for (SimdLevel level : levels) {
+        if (!Verify(level)) {
+            fprintf(stderr, "ValidateUtf8 (%s) mismatch\n", SimdLevelName(level));
+            return 1;
+        }
+    }
+
+    struct Corpus {
+        const char* name;
+        std::string unit;
+    };
+    const Corpus corpora[] = {
+        {"ascii json", "{\"type\":\"ticker\",\"symbol\":\"BTCUSDT\",\"price\":\"64123.50\",\"qty\":\"0.0125\"},"},
+        {"chinese", "服务器收到文本消息后需要校验编码，非法序列以 1007 关闭连接。"},
+        {"emoji", "\xF0\x9F\x98\x80\xF0\x9F\x9A\x80 ok \xF0\x9F\x8E\x89\xF0\x9F\x91\x8D"},
+    };
+    const size_t sizes[] = {64, 1024, 65536};
+    for (const Corpus& corpus : corpora) {
+        for (size_t size : sizes) {
+            std::string text = Repeat(corpus.unit, size);
+            if (!ValidateUtf8Decode(text.data(), text.size())) {
+                fprintf(stderr, "corpus %s invalid\n", corpus.name);
+                return 1;
+            }
+            Bench(std::string(corpus.name) + " decode loop", text, total, ValidateUtf8Decode);
+            for (SimdLevel level : levels) {
+                Bench(std::string(corpus.name) + " ValidateUtf8 (" + SimdLevelName(level) + ")", text, total,
+                      [level](const char* data, size_t len) {
+                          return ValidateUtf8(level, data, len);
+                      });
+            }
+        }
+    }
+    return 0;
+}
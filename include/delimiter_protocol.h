@@ -0,0 +1,49 @@
+#ifndef DELIMITER_PROTOCOL_H
+#define DELIMITER_PROTOCOL_H
+
+#include "server_protocol.h"
+#include "uv_net/simd.h"
+
+// DelimiterProtocol 以单字节分隔符定界（换行、NUL 或自定义字节）
+// 扫描使用 SSE2/AVX2（运行时分派），数据不足时记录已扫描的位置，下次从该位置继续
+// 消息体不含分隔符；strip_cr 为 true 时同时去掉分隔符前的 '\r'（兼容 CRLF）
+class DelimiterProtocol : public ConnectionProtocol {
+public:
+    explicit DelimiterProtocol(char delimiter = '\n', bool strip_cr = true)
+        : delimiter_(delimiter), strip_cr_(strip_cr), scanned_(0) {}
+
+    PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) override {
+        // buff 始终从包起始位置开始，之前扫描过的部分不含分隔符
+        const char* end = buff + len;
+        const char* pos = uv_net::FindByte(buff + scanned_, end, delimiter_);
+        if (pos == end) {
+            scanned_ = len;
+            info.need_len = 1;
+            return PackageLess;
+        }
+
+        scanned_ = 0;
+        size_t payload_len = static_cast<size_t>(pos - buff);
+        if (strip_cr_ && payload_len > 0 && buff[payload_len - 1] == '\r') {
+            --payload_len;
+        }
+        info.package_len = static_cast<size_t>(pos - buff) + 1;
+        info.payload_offset = 0;
+        info.payload_len = payload_len;
+        return PackageFull;
+    }
+
+    // 供 TcpServer::SetProtocolFactory 使用
+    static ConnectionProtocolFactory Factory(char delimiter = '\n', bool strip_cr = true) {
+        return [delimiter, strip_cr] {
+            return std::unique_ptr<ConnectionProtocol>(new DelimiterProtocol(delimiter, strip_cr));
+        };
+    }
+
+private:
+    char delimiter_;
+    bool strip_cr_;
+    size_t scanned_; // 当前包已扫描且不含分隔符的字节数
+};
+
+#endif // DELIMITER_PROTOCOL_H
@@ -2,12 +2,17 @@
 #define FIX_SIZE_PROTOCOL_H
 
 #include "server_protocol.h"
+#include "uv_net/send_buffer.h"
 #include <arpa/inet.h> // 用于网络字节序转换
+#include <cstring>
 
 // FixSizeProtocol类实现了基于4字节网络字节序size定界的协议
 class FixSizeProtocol : public ServerProtocol {
 public:
     virtual ~FixSizeProtocol() = default;
+
+    // 整包长度上限（含4字节size字段）
+    static constexpr size_t kMaxPackageSize = 65535;
     
     // 解析包
     // buff: 缓冲区指针
@@ -27,7 +32,7 @@ public:
         int total_len = ntohl(net_size);
         
         // 检查包大小是否合理（至少包含size字段，且不超过最大限制）
-        if (total_len < 4 || total_len > 65535) {
+        if (total_len < 4 || static_cast<size_t>(total_len) > kMaxPackageSize) {
             return PackageError; // 包大小不合理
         }
         
@@ -42,6 +47,58 @@ public:
         
         return PackageFull; // 包完整
     }
+
+    size_t MaxHeaderSize() const override { return 4; }
+
+    // 在消息体之前写入4字节网络字节序的整包长度
+    bool Encode(uv_net::SendBuffer& buffer) override {
+        return EncodeSize(buffer);
+    }
+
+    static bool EncodeSize(uv_net::SendBuffer& buffer) {
+        size_t total_len = buffer.Size() + 4;
+        if (total_len > kMaxPackageSize) {
+            return false;
+        }
+        uint32_t net_size = htonl(static_cast<uint32_t>(total_len));
+        memcpy(buffer.Prepend(4), &net_size, 4);
+        return true;
+    }
+};
+
+// FixSizeProtocol 的逐连接版本：包头不完整或包体不足时给出还需的字节数，消息体不含size字段
+class FixSizeConnectionProtocol : public ConnectionProtocol {
+public:
+    PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) override {
+        if (len < 4) {
+            info.need_len = 4 - len;
+            return PackageLess;
+        }
+
+        uint32_t net_size;
+        memcpy(&net_size, buff, 4);
+        size_t total_len = ntohl(net_size);
+
+        if (total_len < 4 || total_len > FixSizeProtocol::kMaxPackageSize) {
+            return PackageError;
+        }
+
+        if (len < total_len) {
+            info.need_len = total_len - len;
+            return PackageLess;
+        }
+
+        info.package_len = total_len;
+        info.payload_offset = 4;
+        info.payload_len = total_len - 4;
+        return PackageFull;
+    }
+
+    size_t MaxHeaderSize() const override { return 4; }
+
+    bool Encode(uv_net::SendBuffer& buffer) override {
+        return FixSizeProtocol::EncodeSize(buffer);
+    }
 };
 
 #endif // FIX_SIZE_PROTOCOL_H
\ No newline at end of file
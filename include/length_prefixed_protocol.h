@@ -0,0 +1,229 @@
+#ifndef LENGTH_PREFIXED_PROTOCOL_H
+#define LENGTH_PREFIXED_PROTOCOL_H
+
+#include "server_protocol.h"
+#include "uv_net/send_buffer.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+// 长度字段字节序
+enum class LengthEndian {
+    Big,
+    Little,
+};
+
+// Width 取该值时长度字段为 varint（LEB128，每字节低7位有效，最高位表示后续还有字节）
+static constexpr size_t kVarintLength = 0;
+
+namespace length_prefixed_detail {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr LengthEndian kHostEndian = LengthEndian::Big;
+#else
+static constexpr LengthEndian kHostEndian = LengthEndian::Little;
+#endif
+
+inline uint16_t ByteSwap(uint16_t v) { return __builtin_bswap16(v); }
+inline uint32_t ByteSwap(uint32_t v) { return __builtin_bswap32(v); }
+inline uint64_t ByteSwap(uint64_t v) { return __builtin_bswap64(v); }
+inline uint8_t ByteSwap(uint8_t v) { return v; }
+
+// 定长长度字段：memcpy 到整数后按需 bswap，编译为一次 load + bswap
+template <typename T, LengthEndian Endian>
+struct FixedCodec {
+    static constexpr size_t kMaxHeaderSize = sizeof(T);
+
+    // 返回头部长度，数据不足时返回 0 并通过 need 给出还需的字节数，出错返回 -1
+    static int Decode(const char* buff, size_t len, uint64_t& value, size_t& need) {
+        if (len < sizeof(T)) {
+            need = sizeof(T) - len;
+            return 0;
+        }
+        T raw;
+        memcpy(&raw, buff, sizeof(T));
+        value = Endian == kHostEndian ? raw : ByteSwap(raw);
+        return static_cast<int>(sizeof(T));
+    }
+
+    static size_t Encode(char* out, uint64_t value) {
+        T raw = static_cast<T>(value);
+        raw = Endian == kHostEndian ? raw : ByteSwap(raw);
+        memcpy(out, &raw, sizeof(T));
+        return sizeof(T);
+    }
+};
+
+template <size_t Width, LengthEndian Endian>
+struct LengthCodec;
+
+template <LengthEndian Endian>
+struct LengthCodec<1, Endian> : FixedCodec<uint8_t, Endian> {};
+template <LengthEndian Endian>
+struct LengthCodec<2, Endian> : FixedCodec<uint16_t, Endian> {};
+template <LengthEndian Endian>
+struct LengthCodec<4, Endian> : FixedCodec<uint32_t, Endian> {};
+template <LengthEndian Endian>
+struct LengthCodec<8, Endian> : FixedCodec<uint64_t, Endian> {};
+
+// varint 长度字段，与字节序无关
+template <LengthEndian Endian>
+struct LengthCodec<kVarintLength, Endian> {
+    static constexpr size_t kMaxHeaderSize = 10;
+
+    static int Decode(const char* buff, size_t len, uint64_t& value, size_t& need) {
+        uint64_t result = 0;
+        size_t limit = len;
+        if (limit > kMaxHeaderSize) {
+            limit = kMaxHeaderSize;
+        }
+        for (size_t i = 0; i < limit; ++i) {
+            uint8_t byte = static_cast<uint8_t>(buff[i]);
+            result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0) {
+                value = result;
+                return static_cast<int>(i + 1);
+            }
+        }
+        if (limit == kMaxHeaderSize) {
+            return -1; // 超过10字节仍未结束
+        }
+        need = 1; // 至少还需要一个字节才能确定长度
+        return 0;
+    }
+
+    static size_t Encode(char* out, uint64_t value) {
+        size_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out[n++] = static_cast<char>(value);
+        return n;
+    }
+};
+
+} // namespace length_prefixed_detail
+
+// 长度前缀协议
+// Width: 长度字段字节数（1/2/4/8），或 kVarintLength
+// Endian: 定长字段的字节序
+// Inclusive: 长度值是否包含长度字段自身
+// MaxSize: 整包最大长度，0 表示只受 ServerConfig 的最大包大小限制
+template <size_t Width, LengthEndian Endian = LengthEndian::Big, bool Inclusive = false, size_t MaxSize = 0>
+class LengthPrefixedProtocol : public ConnectionProtocol {
+    using Codec = length_prefixed_detail::LengthCodec<Width, Endian>;
+
+public:
+    static constexpr size_t kMaxHeaderSize = Codec::kMaxHeaderSize;
+
+    PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) override {
+        uint64_t value = 0;
+        size_t need = 0;
+        int header = Codec::Decode(buff, len, value, need);
+        if (header < 0) {
+            return PackageError;
+        }
+        if (header == 0) {
+            info.need_len = need;
+            return PackageLess;
+        }
+
+        size_t header_len = static_cast<size_t>(header);
+        uint64_t total = value;
+        if (Inclusive) {
+            if (value < header_len) {
+                return PackageError;
+            }
+        } else {
+            if (value > std::numeric_limits<uint64_t>::max() - header_len) {
+                return PackageError;
+            }
+            total = value + header_len;
+        }
+        if ((MaxSize > 0 && total > MaxSize) || total > std::numeric_limits<size_t>::max()) {
+            return PackageError;
+        }
+
+        size_t total_len = static_cast<size_t>(total);
+        if (len < total_len) {
+            info.need_len = total_len - len;
+            return PackageLess;
+        }
+
+        info.package_len = total_len;
+        info.payload_offset = header_len;
+        info.payload_len = total_len - header_len;
+        return PackageFull;
+    }
+
+    // 将长度字段写入 out（至少 kMaxHeaderSize 字节），返回长度字段字节数
+    // payload_len 须在长度字段可表示的范围内
+    static size_t EncodeHeader(char* out, size_t payload_len) {
+        uint64_t value = payload_len;
+        if (Inclusive) {
+            // 长度包含字段自身；varint 的字段宽度取决于数值，逐次修正直到稳定
+            char tmp[kMaxHeaderSize];
+            size_t width = Codec::Encode(tmp, payload_len);
+            while (Codec::Encode(tmp, payload_len + width) != width) {
+                ++width;
+            }
+            value = payload_len + width;
+        }
+        return Codec::Encode(out, value);
+    }
+
+    // 编码完整的包：长度字段 + 消息体
+    static std::string Encode(const char* data, size_t len) {
+        char header[kMaxHeaderSize];
+        size_t header_len = EncodeHeader(header, len);
+        std::string package;
+        package.reserve(header_len + len);
+        package.append(header, header_len);
+        package.append(data, len);
+        return package;
+    }
+
+    size_t MaxHeaderSize() const override { return kMaxHeaderSize; }
+
+    // 在 SendBuffer 的消息体之前原地写入长度字段
+    bool Encode(uv_net::SendBuffer& buffer) override {
+        size_t payload_len = buffer.Size();
+        if (!Fits(payload_len)) {
+            return false;
+        }
+        char header[kMaxHeaderSize];
+        size_t header_len = EncodeHeader(header, payload_len);
+        memcpy(buffer.Prepend(header_len), header, header_len);
+        return true;
+    }
+
+    // 消息体长度能否用长度字段表示且不超过 MaxSize
+    static bool Fits(size_t payload_len) {
+        uint64_t total = static_cast<uint64_t>(payload_len) + kMaxHeaderSize;
+        if (MaxSize > 0 && total > MaxSize) {
+            return false;
+        }
+        if (Width == kVarintLength || Width >= 8) {
+            return true;
+        }
+        uint64_t limit = (uint64_t(1) << (8 * (Width % 8))) - 1; // Width 为 0/8 时已在上面返回
+        return (Inclusive ? total : payload_len) <= limit;
+    }
+
+    // 供 TcpServer::SetProtocolFactory 使用
+    static ConnectionProtocolFactory Factory() {
+        return [] { return std::unique_ptr<ConnectionProtocol>(new LengthPrefixedProtocol()); };
+    }
+};
+
+// 常用组合
+using LengthPrefixed16BE = LengthPrefixedProtocol<2, LengthEndian::Big>;
+using LengthPrefixed32LE = LengthPrefixedProtocol<4, LengthEndian::Little>;
+using LengthPrefixed64BE = LengthPrefixedProtocol<8, LengthEndian::Big>;
+using VarintLengthPrefixed = LengthPrefixedProtocol<kVarintLength>;
+// 与 FixSizeProtocol 相同的格式：4字节大端、长度包含自身，上限由 ServerConfig 的最大包大小控制
+using FixSizeLengthPrefixed = LengthPrefixedProtocol<4, LengthEndian::Big, true>;
+
+#endif // LENGTH_PREFIXED_PROTOCOL_H
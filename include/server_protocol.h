@@ -2,6 +2,12 @@
 #define SERVER_PROTOCOL_H
 
 #include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace uv_net {
+class SendBuffer;
+}
 
 enum PackageStatus: int {
 	// PackageLess shows is not a completed package.
@@ -17,6 +23,36 @@ public:
     virtual ~ServerProtocol() = default;
     // 解析包
     virtual PackageStatus ParsePackage(const char* buff, size_t len, int& package_len, int& msg_len) = 0;
+
+    // 发送侧：包头最多占用的字节数，Connection::NewSendBuffer 按此预留头部空间
+    virtual size_t MaxHeaderSize() const { return 0; }
+    // 发送侧：在消息体之前原地写入包头（SendBuffer::Prepend），返回 false 表示无法编码
+    virtual bool Encode(uv_net::SendBuffer& /*buffer*/) { return true; }
 };
 
+// 包解析结果
+struct PackageInfo {
+    size_t package_len = 0;     // PackageFull：整包长度（含包头）
+    size_t payload_offset = 0;  // PackageFull：消息体在包内的偏移
+    size_t payload_len = 0;     // PackageFull：消息体长度
+    size_t need_len = 0;        // PackageLess：至少还需要的字节数，0 表示未知
+    bool batch = false;         // PackageFull：包内含多条独立消息（如 RESP pipelining），不按整包限制大小，单条消息由协议自行限制
+};
+
+// 有状态的逐连接协议解析器，每个连接独立一份，可以在多次调用之间保存解析进度
+// 连接在缓冲数据不足 need_len 之前不会再次调用 Parse，OnMessage 只收到消息体
+class ConnectionProtocol {
+public:
+    virtual ~ConnectionProtocol() = default;
+    // 解析 buff 开头的一个包，buff 始终从包的起始位置开始
+    virtual PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) = 0;
+
+    // 发送侧编码，含义同 ServerProtocol::MaxHeaderSize / Encode
+    virtual size_t MaxHeaderSize() const { return 0; }
+    virtual bool Encode(uv_net::SendBuffer& /*buffer*/) { return true; }
+};
+
+// 为每个连接创建 ConnectionProtocol
+using ConnectionProtocolFactory = std::function<std::unique_ptr<ConnectionProtocol>()>;
+
 #endif // SERVER_PROTOCOL_H
\ No newline at end of file
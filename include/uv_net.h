@@ -5,5 +5,7 @@
 #include "uv_net/tcp_server.h"
 #include "uv_net/udp_server.h"
 #include "uv_net/websocket_server.h"
+#include "uv_net/http_server.h"
+#include "uv_net/resp_server.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef UV_NET_BUFFER_H
+#define UV_NET_BUFFER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace uv_net {
+
+// 持有所有权的内存块，只能移动，析构时调用自定义的释放函数
+// 用于 Connection::Send(Buffer&&)，数据直接进入发送队列，写完成后才释放
+class Buffer {
+public:
+    using Deleter = std::function<void(char* data, size_t len)>;
+
+    Buffer() : data_(nullptr), len_(0) {}
+    Buffer(char* data, size_t len, Deleter deleter)
+        : data_(data), len_(len), deleter_(std::move(deleter)) {}
+
+    // 接管 new[] 分配的内存
+    static Buffer FromArray(char* data, size_t len) {
+        return Buffer(data, len, [](char* p, size_t) { delete[] p; });
+    }
+
+    // 接管 std::string，内容不拷贝
+    static Buffer FromString(std::string&& str) {
+        std::string* holder = new std::string(std::move(str));
+        return Buffer(&(*holder)[0], holder->size(), [holder](char*, size_t) { delete holder; });
+    }
+
+    Buffer(Buffer&& other) noexcept
+        : data_(other.data_), len_(other.len_), deleter_(std::move(other.deleter_)) {
+        other.data_ = nullptr;
+        other.len_ = 0;
+        other.deleter_ = nullptr;
+    }
+
+    Buffer& operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            data_ = other.data_;
+            len_ = other.len_;
+            deleter_ = std::move(other.deleter_);
+            other.data_ = nullptr;
+            other.len_ = 0;
+            other.deleter_ = nullptr;
+        }
+        return *this;
+    }
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    ~Buffer() { Reset(); }
+
+    char* Data() const { return data_; }
+    size_t Size() const { return len_; }
+    bool Empty() const { return len_ == 0; }
+
+    // 释放持有的内存
+    void Reset() {
+        if (deleter_) {
+            deleter_(data_, len_);
+        }
+        data_ = nullptr;
+        len_ = 0;
+        deleter_ = nullptr;
+    }
+
+private:
+    char* data_;
+    size_t len_;
+    Deleter deleter_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_BUFFER_H
@@ -5,8 +5,11 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <sys/uio.h>
 #include <plog/Log.h>
 #include "server_protocol.h"
+#include "buffer.h"
+#include "send_buffer.h"
 
 namespace uv_net {
 
@@ -20,15 +23,82 @@ using CallbackOpen = std::function<void(std::shared_ptr<class Connection>)>;
 using CallbackMessage = std::function<void(std::shared_ptr<class Connection>, const char* data, size_t len)>;
 using CallbackClose = std::function<void(std::shared_ptr<class Connection>)>;
 
+// 连接往返时延（微秒），由服务器发出的心跳 Ping 与对端的 Pong 测得
+struct RttStats {
+    int64_t last_us = 0;   // 最近一次
+    int64_t ewma_us = 0;   // 平滑值（权重 1/8，同 TCP SRTT）
+    int64_t max_us = 0;    // 最大值
+    uint64_t samples = 0;  // 样本数，0 表示尚未测得
+};
+
+// 往返时延分布，按 2 的幂分桶：桶 0 为 0，桶 i 为 [2^(i-1), 2^i) 微秒
+struct RttHistogram {
+    static const int kBuckets = 32;
+    uint64_t counts[kBuckets] = {};
+    uint64_t total = 0;
+
+    void Record(int64_t us) {
+        int bucket = 0;
+        if (us > 0) {
+            bucket = 64 - __builtin_clzll(static_cast<unsigned long long>(us));
+            bucket = bucket < kBuckets ? bucket : kBuckets - 1;
+        }
+        counts[bucket]++;
+        total++;
+    }
+
+    // 分位数 p（0～1）所在桶的上界（微秒），没有样本返回 0
+    int64_t Percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(p * total);
+        target = target < total ? target : total - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen > target) {
+                return i == 0 ? 0 : static_cast<int64_t>(1) << i;
+            }
+        }
+        return static_cast<int64_t>(1) << (kBuckets - 1);
+    }
+};
+
 // 抽象连接类
 class Connection {
 public:
     virtual ~Connection() = default;
     virtual void Send(const char* data, size_t len) = 0;
+    // 分散的多段数据作为一条消息发送，调用返回后各段内存即可复用
+    virtual void Send(const struct iovec* iov, size_t iovcnt) {
+        size_t total = 0;
+        for (size_t i = 0; i < iovcnt; ++i) {
+            total += iov[i].iov_len;
+        }
+        std::string data;
+        data.reserve(total);
+        for (size_t i = 0; i < iovcnt; ++i) {
+            data.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+        }
+        Send(std::move(data));
+    }
+    // 转移所有权的发送，支持的连接直接将数据放入发送队列
+    virtual void Send(std::string&& data) { Send(data.data(), data.size()); }
+    virtual void Send(Buffer&& buffer) { Send(buffer.Data(), buffer.Size()); }
+    // 分配按连接协议预留了包头空间的发送缓冲区，消息体写入后交给 SendPackage
+    virtual SendBuffer NewSendBuffer(size_t capacity) { return SendBuffer(0, capacity); }
+    // 由连接协议在缓冲区内原地写入包头后发送，没有协议时原样发送
+    virtual void SendPackage(SendBuffer&& buffer) { Send(buffer.Release()); }
+    // Cork 期间的 Send 只入队，Uncork 时合并发出；可嵌套，不支持的连接忽略
+    virtual void Cork() {}
+    virtual void Uncork() {}
     virtual void Close() = 0;
     virtual std::string GetIP() = 0;
     virtual int GetPort() = 0;
     virtual uint32_t GetConnId() = 0;
+    // 往返时延，不测量 RTT 的连接 samples 为 0
+    virtual RttStats GetRtt() const { return RttStats(); }
 };
 
 // 基础 Server 接口
@@ -0,0 +1,63 @@
+#ifndef UV_NET_HTTP_PARSER_H
+#define UV_NET_HTTP_PARSER_H
+
+#include "server_protocol.h"
+#include "string_view.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace uv_net {
+
+struct HttpHeader {
+    StringView name;
+    StringView value;
+};
+
+// 解析后的 HTTP 请求，所有字段均为指向接收缓冲区的视图，仅在请求回调期间有效
+struct HttpRequest {
+    static const size_t kMaxHeaders = 64;
+
+    StringView method;
+    StringView target;   // 原始请求目标，如 /path?a=1
+    StringView path;     // target 中 '?' 之前的部分
+    StringView query;    // target 中 '?' 之后的部分
+    int minor_version = 1; // HTTP/1.x
+    HttpHeader headers[kMaxHeaders];
+    size_t header_count = 0;
+    size_t content_length = 0;
+    StringView body;
+    bool keep_alive = true;
+
+    // 按名称（大小写不敏感）查找头部，不存在时返回空视图
+    StringView GetHeader(StringView name) const;
+};
+
+// 零拷贝的 HTTP/1.x 请求头解析器，按行扫描使用 SIMD 查找换行
+class HttpParser {
+public:
+    // 解析 [data, data + head_len) 中的请求行和头部（head_len 包含结尾的空行）
+    static bool ParseHead(const char* data, size_t head_len, HttpRequest& req);
+    // 在 [data + from, data + len) 中查找头部结束位置，返回头部长度（含空行），未找到返回 0
+    static size_t FindHeadEnd(const char* data, size_t len, size_t from);
+};
+
+// HTTP 请求的逐连接定界协议：头部结束前记录扫描位置，包体按 Content-Length 给出还需的字节数
+// 不支持 Transfer-Encoding 请求体（视为错误）
+class HttpProtocol : public ConnectionProtocol {
+public:
+    HttpProtocol() : scanned_(0), head_len_(0) {}
+
+    PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) override;
+
+    // 最近一次 PackageFull 的请求，视图指向传给 Parse 的缓冲区
+    const HttpRequest& GetRequest() const { return request_; }
+
+private:
+    size_t scanned_;   // 已扫描且未找到头部结尾的字节数
+    size_t head_len_;  // 已确定的头部长度，0 表示未知
+    HttpRequest request_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_HTTP_PARSER_H
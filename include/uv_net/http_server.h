@@ -0,0 +1,66 @@
+#ifndef UV_NET_HTTP_SERVER_H
+#define UV_NET_HTTP_SERVER_H
+
+#include "connection.h"
+#include "server_config.h"
+#include "tcp_server.h"
+#include "http_parser.h"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace uv_net {
+
+// HTTP 响应，请求回调返回后若尚未调用 End 则自动发送
+class HttpResponse {
+public:
+    HttpResponse(std::shared_ptr<Connection> conn, const HttpRequest& req);
+
+    void SetStatus(int code, const char* reason = nullptr);
+    void AddHeader(StringView name, StringView value);
+    // 借用的包体，须在 End 之前保持有效
+    void SetBody(const char* data, size_t len);
+    // 转移所有权的包体
+    void SetBody(std::string&& body);
+
+    // 响应头与包体通过一次 writev 发出；非 keep-alive 请求在发送后关闭连接
+    // HEAD 请求只发送头部（Content-Length 仍为包体长度），1xx/204/304 响应不带包体和 Content-Length
+    void End();
+    bool IsEnded() const { return ended_; }
+
+private:
+    std::shared_ptr<Connection> conn_;
+    int minor_version_;
+    bool keep_alive_;
+    bool head_request_;
+    bool ended_;
+    std::string head_;        // 状态行之后的头部
+    int status_;
+    const char* reason_;
+    const char* body_data_;
+    size_t body_len_;
+    std::string body_;
+    bool body_owned_;
+};
+
+using CallbackRequest = std::function<void(std::shared_ptr<Connection>, const HttpRequest&, HttpResponse&)>;
+
+// HTTP/1.x Server：支持 keep-alive 与 pipelining，请求按到达顺序回调并按顺序响应
+// 默认开启发送合并，一次读取中的多个 pipelining 请求的响应合并为一次 writev
+class HttpServer : public TcpServer {
+public:
+    HttpServer(uv_loop_t* loop, const ServerConfig& config = ServerConfig());
+    ~HttpServer();
+
+    void SetOnRequest(CallbackRequest cb) { on_request_ = cb; }
+
+private:
+    // 内部回调
+    void OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len) override;
+
+    CallbackRequest on_request_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_HTTP_SERVER_H
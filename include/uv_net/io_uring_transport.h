@@ -0,0 +1,145 @@
+#ifndef UV_NET_IO_URING_TRANSPORT_H
+#define UV_NET_IO_URING_TRANSPORT_H
+
+#include "tcp_connection.h"
+#include <string>
+#include <unordered_set>
+#include <cstdint>
+
+// 内核结构体前向声明，避免在头文件中引入 <linux/io_uring.h>
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace uv_net {
+
+class TcpServer;
+class IoUringLoop;
+class IoUringConnection;
+
+// io_uring 请求上下文，地址作为 SQE 的 user_data
+struct IoUringOp {
+    enum class Type : uint8_t {
+        ACCEPT,
+        RECV,
+        SEND,
+        CANCEL
+    };
+
+    Type type;
+    IoUringConnection* conn;
+};
+
+// io_uring 传输层，挂接在 libuv loop 上：
+// ring fd 通过 uv_poll_t 感知完成事件，SQE 在每轮循环的 uv_prepare_t 中批量提交。
+// accept 使用 multishot accept，recv 使用 multishot recv + provided buffer ring。
+class IoUringLoop {
+    friend class IoUringConnection;
+public:
+    IoUringLoop(uv_loop_t* loop, TcpServer* server);
+    ~IoUringLoop();
+
+    // 运行时探测内核是否支持所需的 io_uring 特性
+    static bool IsSupported();
+
+    // 初始化 ring、provided buffer ring 以及 libuv 句柄
+    bool Init(unsigned queue_depth, unsigned buffer_count, unsigned buffer_size);
+    // 创建监听 socket 并投递 multishot accept
+    bool Listen(const std::string& ip, int port);
+
+private:
+    // 关闭仍然存活的连接，同步等待它们在 ring 上的请求完成
+    void ShutdownConnections();
+    ::io_uring_sqe* GetSqe();
+    void Submit();
+    void ReapCompletions();
+    void HandleAccept(int res, uint32_t flags);
+    void HandleRecv(IoUringConnection* conn, int res, uint32_t flags);
+    void HandleSend(IoUringConnection* conn, int res);
+
+    void ArmAccept();
+    void ArmRecv(IoUringConnection* conn);
+    void ArmSend(IoUringConnection* conn);
+    void CancelRecv(IoUringConnection* conn);
+    void RecycleBuffer(uint16_t bid);
+
+    uv_loop_t* loop_;
+    TcpServer* server_;
+    int ring_fd_;
+    int listen_fd_;
+
+    // SQ/CQ ring 映射
+    void* ring_ptr_;
+    size_t ring_size_;
+    ::io_uring_sqe* sqes_;
+    size_t sqes_size_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    ::io_uring_cqe* cqes_;
+    unsigned sqe_tail_;      // 本地已填充的 SQE 尾部
+    unsigned sqe_submitted_; // 已发布给内核的 SQE 尾部
+
+    // provided buffer ring
+    ::io_uring_buf_ring* buf_ring_;
+    size_t buf_ring_size_;
+    char* buffers_;
+    unsigned buffer_count_;
+    unsigned buffer_size_;
+    uint16_t buf_tail_;
+
+    IoUringOp accept_op_;
+
+    // 尚未释放的连接，析构时先关闭它们并等待 ring 上的请求完成
+    std::unordered_set<IoUringConnection*> connections_;
+
+    // libuv 句柄，单独分配以便在 close 回调中释放
+    uv_poll_t* poll_handle_;
+    uv_prepare_t* prepare_handle_;
+};
+
+// 基于 io_uring 的 TCP 连接，对业务层暴露与 TcpConnection 相同的接口
+class IoUringConnection : public TcpConnection {
+    friend class IoUringLoop;
+public:
+    IoUringConnection(TcpServer* server, IoUringLoop* ring, int fd);
+    ~IoUringConnection() override;
+
+    using TcpConnection::Send;
+    // 没有 libuv stream，分散数据拷贝为一条消息入队
+    void Send(const struct iovec* iov, size_t iovcnt) override { Connection::Send(iov, iovcnt); }
+    void Close() override;
+    void TrySend() override;
+    void OnWriteComplete(int status) override;
+    void CloseImmediately() override;
+
+protected:
+    int GetSocketFd() override { return fd_; }
+    uv_loop_t* GetLoop() override;
+
+private:
+    // 取消接收并在所有请求（包括线程池中的 sendfile）完成后释放连接
+    void BeginShutdown();
+    void MaybeFinalize();
+
+    IoUringLoop* ring_;
+    int fd_;
+    int pending_ops_;   // 尚未完成的 io_uring 请求数
+    bool recv_armed_;   // multishot recv 是否仍然有效
+    bool finalized_;
+
+    IoUringOp recv_op_;
+    IoUringOp send_op_;
+    IoUringOp cancel_op_;
+    SendItem sending_;      // 正在发送的数据
+    size_t send_offset_;    // 已发送的字节数
+};
+
+} // namespace uv_net
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef UV_NET_RESP_PROTOCOL_H
+#define UV_NET_RESP_PROTOCOL_H
+
+#include "server_protocol.h"
+#include "string_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace uv_net {
+
+// 一条 RESP 命令，参数为指向接收缓冲区的视图
+struct RespCommand {
+    const StringView* args;
+    size_t argc;
+
+    StringView Name() const { return argc > 0 ? args[0] : StringView(); }
+    // 命令名大小写不敏感比较
+    bool Is(StringView name) const { return argc > 0 && args[0].EqualsIgnoreCase(name); }
+};
+
+// 一次读取中到达的全部完整命令（pipelining），仅在回调期间有效
+class RespBatch {
+public:
+    size_t Size() const { return commands_.size(); }
+    RespCommand operator[](size_t i) const {
+        return RespCommand{args_.data() + commands_[i].first, commands_[i].second};
+    }
+
+private:
+    friend class RespProtocol;
+    std::vector<StringView> args_;
+    std::vector<std::pair<size_t, size_t>> commands_; // (首个参数下标, 参数个数)
+};
+
+// 回复缓冲区：一批命令的回复追加到同一块内存，回调结束后一次写出
+class RespReply {
+public:
+    void SimpleString(StringView str);
+    void Error(StringView message);
+    void Integer(int64_t value);
+    void BulkString(StringView str);
+    void Null();
+    void ArrayHeader(size_t count);
+
+    std::string& Buffer() { return buffer_; }
+
+private:
+    void AppendNumber(char type, int64_t value);
+
+    std::string buffer_;
+};
+
+// RESP 请求定界协议：增量解析数组（元素为 bulk string、integer、simple string）和 inline 命令
+// 一次 Parse 返回缓冲区中全部完整命令；不完整的命令保留解析进度（以偏移记录），下次从断点继续
+// 大小限制作用于单条命令（RespServer 取 ServerConfig::GetMaxPackageSize），pipelining 的整批不受限
+class RespProtocol : public ConnectionProtocol {
+public:
+    explicit RespProtocol(size_t max_command_size = SIZE_MAX);
+
+    PackageStatus Parse(const char* buff, size_t len, PackageInfo& info) override;
+
+    // 最近一次 PackageFull 的命令批次，只含空数组或空行时为空
+    const RespBatch& GetBatch() const { return batch_; }
+
+private:
+    // 解析 [pos_, len) 中的数据，返回 false 表示协议错误
+    bool ParseMore(const char* buff, size_t len);
+    // 读取 pos 开始的一行（以 \r\n 结束），返回行结束后的位置，不完整返回 0
+    static size_t ReadLine(const char* buff, size_t len, size_t pos, size_t& line_end);
+    static bool ParseInteger(const char* begin, const char* end, int64_t& value);
+    // 当前命令解析到 end 时是否超过单条命令的大小限制
+    bool CommandTooLarge(size_t end) const { return end - command_start_ > max_command_size_; }
+
+    struct Span {
+        size_t offset;
+        size_t len;
+    };
+
+    size_t max_command_size_; // 单条命令的最大字节数
+    size_t pos_;              // 已解析到的位置
+    size_t command_start_;    // 当前命令的起始位置
+    size_t complete_end_;     // 最后一条完整命令的结束位置
+    int64_t pending_args_;    // 当前命令还需的元素数，-1 表示不在命令中
+    size_t pending_bulk_;     // 正在等待的 bulk string 长度（含 \r\n），0 表示无
+    size_t need_hint_;        // 不完整时至少还需的字节数
+    size_t command_first_;    // 当前命令首个参数在 spans_ 中的下标
+    std::vector<Span> spans_; // 参数位置（相对当前包起始）
+    std::vector<std::pair<size_t, size_t>> commands_;
+    RespBatch batch_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_RESP_PROTOCOL_H
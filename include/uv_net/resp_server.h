@@ -0,0 +1,33 @@
+#ifndef UV_NET_RESP_SERVER_H
+#define UV_NET_RESP_SERVER_H
+
+#include "connection.h"
+#include "server_config.h"
+#include "tcp_server.h"
+#include "resp_protocol.h"
+#include <functional>
+#include <memory>
+
+namespace uv_net {
+
+// 命令批次回调：按顺序处理 batch 中的命令并把回复追加到 reply，回调返回后 reply 一次写出
+using CallbackCommandBatch = std::function<void(std::shared_ptr<Connection>, const RespBatch&, RespReply&)>;
+
+// RESP (Redis 协议) Server：一次读取中 pipelining 的全部命令在一次回调中交给上层
+class RespServer : public TcpServer {
+public:
+    RespServer(uv_loop_t* loop, const ServerConfig& config = ServerConfig());
+    ~RespServer();
+
+    void SetOnCommandBatch(CallbackCommandBatch cb) { on_command_batch_ = cb; }
+
+private:
+    // 内部回调
+    void OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len) override;
+
+    CallbackCommandBatch on_command_batch_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_RESP_SERVER_H
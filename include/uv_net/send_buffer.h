@@ -0,0 +1,106 @@
+#ifndef UV_NET_SEND_BUFFER_H
+#define UV_NET_SEND_BUFFER_H
+
+#include "buffer.h"
+#include <cstddef>
+#include <cstring>
+
+namespace uv_net {
+
+// 带预留头部空间的发送缓冲区：先写消息体，再由协议在消息体之前原地写入包头
+// 通过 Release 转为 Buffer 交给发送队列，整个过程消息体不做拷贝
+class SendBuffer {
+public:
+    SendBuffer() : storage_(nullptr), capacity_(0), begin_(0), end_(0) {}
+    // headroom: 消息体之前预留的字节数；capacity: 消息体的初始容量
+    SendBuffer(size_t headroom, size_t capacity)
+        : storage_(new char[headroom + capacity]), capacity_(headroom + capacity), begin_(headroom), end_(headroom) {}
+
+    SendBuffer(SendBuffer&& other) noexcept
+        : storage_(other.storage_), capacity_(other.capacity_), begin_(other.begin_), end_(other.end_) {
+        other.storage_ = nullptr;
+        other.capacity_ = other.begin_ = other.end_ = 0;
+    }
+
+    SendBuffer& operator=(SendBuffer&& other) noexcept {
+        if (this != &other) {
+            delete[] storage_;
+            storage_ = other.storage_;
+            capacity_ = other.capacity_;
+            begin_ = other.begin_;
+            end_ = other.end_;
+            other.storage_ = nullptr;
+            other.capacity_ = other.begin_ = other.end_ = 0;
+        }
+        return *this;
+    }
+
+    SendBuffer(const SendBuffer&) = delete;
+    SendBuffer& operator=(const SendBuffer&) = delete;
+
+    ~SendBuffer() { delete[] storage_; }
+
+    char* Data() const { return storage_ + begin_; }
+    size_t Size() const { return end_ - begin_; }
+    bool Empty() const { return end_ == begin_; }
+    size_t Headroom() const { return begin_; }
+    size_t Tailroom() const { return capacity_ - end_; }
+
+    // 追加数据，尾部空间不足时扩容（保留现有头部空间）
+    void Append(const char* data, size_t len) {
+        memcpy(WritableTail(len), data, len);
+        end_ += len;
+    }
+
+    // 返回至少 len 字节的尾部可写空间，写入后调用 Commit
+    char* WritableTail(size_t len) {
+        if (Tailroom() < len) {
+            Reallocate(begin_, len > Size() ? len : Size());
+        }
+        return storage_ + end_;
+    }
+
+    void Commit(size_t len) { end_ += len; }
+
+    // 在当前数据之前占用 len 字节并返回其起始位置，用于原地写入包头
+    // 头部空间不足时重新分配（消息体会被拷贝一次）
+    char* Prepend(size_t len) {
+        if (begin_ < len) {
+            Reallocate(len, Tailroom());
+        }
+        begin_ -= len;
+        return storage_ + begin_;
+    }
+
+    // 交出内存，剩余头部空间随 Buffer 一起释放
+    Buffer Release() {
+        char* storage = storage_;
+        Buffer buffer(storage_ + begin_, Size(), [storage](char*, size_t) { delete[] storage; });
+        storage_ = nullptr;
+        capacity_ = begin_ = end_ = 0;
+        return buffer;
+    }
+
+private:
+    void Reallocate(size_t headroom, size_t tailroom) {
+        size_t size = Size();
+        char* storage = new char[headroom + size + tailroom];
+        if (size > 0) {
+            memcpy(storage + headroom, storage_ + begin_, size);
+        }
+        delete[] storage_;
+        storage_ = storage;
+        capacity_ = headroom + size + tailroom;
+        begin_ = headroom;
+        end_ = headroom + size;
+    }
+
+    char* storage_;
+    size_t capacity_;
+    size_t begin_;
+    size_t end_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_SEND_BUFFER_H
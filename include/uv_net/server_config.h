@@ -17,7 +17,11 @@ public:
         max_package_size_(65536),         // 默认最大包大小64KB
         connection_read_timeout_(30000),  // 默认连接读超时30秒
         heartbeat_interval_(60000),       // 默认心跳间隔60秒
-        tcp_no_delay_(true)               // 默认启用TCP_NODELAY
+        tcp_no_delay_(true),              // 默认启用TCP_NODELAY
+        use_io_uring_(false),             // 默认使用libuv传输
+        io_uring_buffer_count_(1024),     // 默认io_uring接收缓冲区数量
+        zerocopy_threshold_(0),           // 默认关闭MSG_ZEROCOPY
+        auto_flush_(false)                // 默认Send立即发起写
     {}
 
     // 读缓冲区大小设置
@@ -52,6 +56,22 @@ public:
     void SetTcpNoDelay(bool enable) { tcp_no_delay_ = enable; }
     bool GetTcpNoDelay() const { return tcp_no_delay_; }
 
+    // io_uring传输设置（仅Linux，内核不支持时自动回退到libuv）
+    void SetUseIoUring(bool enable) { use_io_uring_ = enable; }
+    bool GetUseIoUring() const { return use_io_uring_; }
+
+    // io_uring接收缓冲区数量（provided buffer ring，需为2的幂），每个缓冲区大小为读缓冲区大小
+    void SetIoUringBufferCount(size_t count) { io_uring_buffer_count_ = count; }
+    size_t GetIoUringBufferCount() const { return io_uring_buffer_count_; }
+
+    // MSG_ZEROCOPY阈值（字节），大于等于该值的发送使用零拷贝，0表示关闭（仅Linux，适合MB级数据）
+    void SetZeroCopyThreshold(size_t size) { zerocopy_threshold_ = size; }
+    size_t GetZeroCopyThreshold() const { return zerocopy_threshold_; }
+
+    // 发送合并：一轮事件循环内的Send在循环末尾统一以一次writev发出（UDP为sendmmsg），延迟不超过一轮循环
+    void SetAutoFlush(bool enable) { auto_flush_ = enable; }
+    bool GetAutoFlush() const { return auto_flush_; }
+
 private:
     size_t read_buffer_size_;          // 读缓冲区大小
     size_t write_buffer_size_;         // 写缓冲区大小
@@ -61,6 +81,10 @@ private:
     int64_t connection_read_timeout_;   // 连接读超时（毫秒）
     int64_t heartbeat_interval_;        // 心跳间隔（毫秒）
     bool tcp_no_delay_;                // TCP_NODELAY开关
+    bool use_io_uring_;                // io_uring传输开关
+    size_t io_uring_buffer_count_;     // io_uring接收缓冲区数量
+    size_t zerocopy_threshold_;        // MSG_ZEROCOPY阈值
+    bool auto_flush_;                  // 发送合并开关
 };
 
 } // namespace uv_net
@@ -0,0 +1,53 @@
+#ifndef UV_NET_SIMD_H
+#define UV_NET_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace uv_net {
+
+// 运行时检测到的指令集级别，热点函数按此分派
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    SSE42,  // 含 SSSE3 的 pshufb/palignr，UTF-8 校验使用；其他函数按 SSE2 处理
+    AVX2
+};
+
+// 当前CPU支持的最高级别（首次调用时检测）
+SimdLevel GetSimdLevel();
+const char* SimdLevelName(SimdLevel level);
+
+// 在 [begin, end) 中查找字节 c，未找到返回 end
+const char* FindByte(const char* begin, const char* end, char c);
+// 指定实现，level 高于CPU支持时退回可用的最高级别（供性能测试对比）
+const char* FindByte(SimdLevel level, const char* begin, const char* end, char c);
+
+// WebSocket 掩码：data[i] ^= key[(offset + i) % 4]，原地处理（掩码与解掩码相同）
+// offset 为 data 起始字节在该帧载荷中的位置，分段到达的载荷可以逐段处理
+void MaskBytes(char* data, size_t len, const uint8_t key[4], size_t offset = 0);
+void MaskBytes(SimdLevel level, char* data, size_t len, const uint8_t key[4], size_t offset = 0);
+
+// UTF-8 校验（RFC 3629：拒绝超长编码、代理项和大于 U+10FFFF 的码点），[data, data + len) 必须以完整的字符结尾
+bool ValidateUtf8(const char* data, size_t len);
+bool ValidateUtf8(SimdLevel level, const char* data, size_t len);
+
+// 增量 UTF-8 校验：分片到达的文本消息逐段调用 Update，跨段的不完整字符暂存到下一段
+class Utf8Validator {
+public:
+    Utf8Validator() : pending_len_(0) {}
+
+    // 校验下一段数据，发现非法序列（包括不完整字符的非法前缀）返回 false
+    bool Update(const char* data, size_t len);
+    // 消息结束时调用：末尾不能留有不完整的字符
+    bool Finish() const { return pending_len_ == 0; }
+    void Reset() { pending_len_ = 0; }
+
+private:
+    char pending_[4];
+    size_t pending_len_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_SIMD_H
@@ -0,0 +1,62 @@
+#ifndef UV_NET_STRING_VIEW_H
+#define UV_NET_STRING_VIEW_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace uv_net {
+
+// 不持有内存的字符串视图（C++14 没有 std::string_view），生命周期由被引用的缓冲区决定
+class StringView {
+public:
+    StringView() : data_(nullptr), size_(0) {}
+    StringView(const char* data, size_t size) : data_(data), size_(size) {}
+    StringView(const char* str) : data_(str), size_(str ? strlen(str) : 0) {}
+    StringView(const std::string& str) : data_(str.data()), size_(str.size()) {}
+
+    const char* Data() const { return data_; }
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    char operator[](size_t i) const { return data_[i]; }
+
+    std::string ToString() const { return std::string(data_, size_); }
+
+    bool operator==(StringView other) const {
+        return size_ == other.size_ && (size_ == 0 || memcmp(data_, other.data_, size_) == 0);
+    }
+    bool operator!=(StringView other) const { return !(*this == other); }
+
+    // ASCII 大小写不敏感比较（HTTP 头部名称等）
+    bool EqualsIgnoreCase(StringView other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            if (ToLower(data_[i]) != ToLower(other.data_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    StringView Substr(size_t pos, size_t len = std::string::npos) const {
+        if (pos > size_) {
+            pos = size_;
+        }
+        if (len > size_ - pos) {
+            len = size_ - pos;
+        }
+        return StringView(data_ + pos, len);
+    }
+
+private:
+    static char ToLower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c; }
+
+    const char* data_;
+    size_t size_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_STRING_VIEW_H
@@ -3,6 +3,8 @@
 
 #include "connection.h"
 #include <queue>
+#include <list>
+#include <vector>
 #include <mutex>
 #include <cstdint>
 
@@ -10,6 +12,17 @@ namespace uv_net {
 
 class TcpServer;
 
+// SendFile 完成回调，status 为 0 表示成功，否则为 libuv 错误码
+using CallbackSendFile = std::function<void(std::shared_ptr<Connection>, int status)>;
+
+// MSG_ZEROCOPY 发送统计
+struct ZeroCopyStats {
+    uint64_t sends = 0;        // 零拷贝 send 调用次数（每次对应一个内核完成序号）
+    uint64_t bytes = 0;        // 以零拷贝方式提交的字节数
+    uint64_t completions = 0;  // 已收到的完成通知数
+    uint64_t copied = 0;       // 内核回退为拷贝的次数（SO_EE_CODE_ZEROCOPY_COPIED）
+};
+
 // TCP 连接实现
 class TcpConnection : public Connection {
 public:
@@ -24,29 +37,134 @@ public:
     TcpConnection(TcpServer* server);
     ~TcpConnection() override;
 
+    using Connection::Send;
     // 业务调用的 Send
     void Send(const char* data, size_t len) override;
+    // 发送队列空闲时直接 writev 各段，剩余部分拷贝进队列
+    void Send(const struct iovec* iov, size_t iovcnt) override;
+    // 数据所有权转移进发送队列，不做拷贝
+    void Send(std::string&& data) override;
+    void Send(Buffer&& buffer) override;
+    // 包头空间取连接协议（ConnectionProtocol 或 ServerProtocol）的 MaxHeaderSize
+    SendBuffer NewSendBuffer(size_t capacity) override;
+    void SendPackage(SendBuffer&& buffer) override;
+    void Cork() override;
+    void Uncork() override;
+    // 零拷贝发送文件区间（sendfile），与 Send 的数据保持顺序，完成后触发回调
+    // fd 由调用方持有，须在回调触发前保持打开
+    virtual void SendFile(int fd, int64_t offset, size_t length, CallbackSendFile cb = nullptr);
     void Close() override;
     std::string GetIP() override;
     int GetPort() override;
     uint32_t GetConnId() override;
 
+    // 大于等于阈值的数据使用 MSG_ZEROCOPY 发送，0 表示关闭（默认取 ServerConfig 的配置）
+    void SetZeroCopyThreshold(size_t threshold) { zerocopy_threshold_ = threshold; }
+    size_t GetZeroCopyThreshold() const { return zerocopy_threshold_; }
+    const ZeroCopyStats& GetZeroCopyStats() const { return zerocopy_stats_; }
+
+    // 逐连接协议解析器，未设置工厂或尚未收到数据时为 nullptr
+    ConnectionProtocol* GetProtocol() const { return protocol_.get(); }
+
     // 内部逻辑
     virtual void TrySend();
+    void FlushSend(); // 开启发送合并时由 TcpServer 在本轮循环末尾调用
     virtual void OnWriteComplete(int status);
     virtual void StartHeartbeat();
     virtual void StopHeartbeat();
     virtual void OnHeartbeatTimeout();
     virtual void OnDataReceived(const char* data, size_t len); // 处理接收到的数据
+    // 不等待发送队列立即关闭（对端断开、发送出错），优雅关闭进行中时同样生效；
+    // 线程池中的 sendfile 仍在使用 socket 时推迟到其完成回调中关闭
+    virtual void CloseImmediately();
 
 protected:
+    // 发送队列元素：内存数据（std::string 或 Buffer）或文件区间
+    struct SendItem {
+        std::string data;
+        Buffer buffer;           // 非空时代替 data
+        int file_fd;             // 文件描述符，-1 表示内存数据
+        int64_t file_offset;     // 文件起始偏移
+        size_t file_length;      // 文件区间长度
+        CallbackSendFile file_cb;
+
+        SendItem(const char* d, size_t len) : data(d, len), file_fd(-1), file_offset(0), file_length(0) {}
+        SendItem(std::string&& d) : data(std::move(d)), file_fd(-1), file_offset(0), file_length(0) {}
+        SendItem(const std::string& d) : data(d), file_fd(-1), file_offset(0), file_length(0) {}
+        SendItem(Buffer&& b) : buffer(std::move(b)), file_fd(-1), file_offset(0), file_length(0) {}
+        SendItem() : file_fd(-1), file_offset(0), file_length(0) {}
+        SendItem(int fd, int64_t offset, size_t length, CallbackSendFile cb)
+            : file_fd(fd), file_offset(offset), file_length(length), file_cb(std::move(cb)) {}
+
+        bool IsFile() const { return file_fd >= 0; }
+        const char* Data() const { return buffer.Data() ? buffer.Data() : data.data(); }
+        size_t Size() const { return buffer.Data() ? buffer.Size() : data.size(); }
+    };
+
+    // 单次 writev 合并的最大队列元素数
+    static const size_t kMaxWriteBufs = 64;
+
     // 写请求结构体，携带数据缓冲区
     struct WriteReq {
         uv_write_t req;
         std::string data; // 持有数据，防止在回调结束前被释放
+        std::vector<SendItem> items; // 一次 writev 合并发送的队列元素
     };
 
-    std::queue<std::string> send_queue_;
+    // sendfile 请求，在线程池中执行 sendfile(2)，socket 不可写时回到 loop 等待
+    struct SendFileReq {
+        uv_work_t work;
+        TcpConnection* conn;
+        int sock_fd;
+        int file_fd;
+        int64_t offset;
+        size_t remaining;
+        int status;          // 0 成功，<0 为错误码
+        bool would_block;    // socket 发送缓冲区已满
+        bool running;        // 正在线程池中执行，期间 sock_fd 必须保持打开
+        CallbackSendFile cb;
+    };
+
+    // 底层 socket 及所属 loop，供 sendfile 等绕过 stream 句柄的发送路径使用
+    virtual int GetSocketFd();
+    virtual uv_loop_t* GetLoop();
+
+    // MSG_ZEROCOPY 发送的缓冲区，收到覆盖全部序号的完成通知后才释放
+    struct ZeroCopyBuffer {
+        SendItem item;
+        size_t sent;           // 已提交给内核的字节数
+        uint32_t first_seq;    // 第一个完成序号
+        uint32_t last_seq;     // 最后一个完成序号
+        uint32_t outstanding;  // 尚未收到完成通知的序号数
+    };
+
+    void StartSendFile(SendItem&& item);
+    void ContinueSendFile();
+    void FinishSendFile(int status);
+    bool UseZeroCopy(size_t len);
+    void StartZeroCopy(SendItem&& item);
+    void ContinueZeroCopy();
+    // 读取错误队列中的完成通知并释放对应缓冲区
+    void DrainZeroCopyCompletions();
+    // 发送路径出错后字节流无法恢复，丢弃队列并关闭连接
+    void AbortSend(int status);
+    bool IsSendIdle() const { return send_queue_.empty() && !is_writing_ && zerocopy_pending_.empty(); }
+    // dup 出独立的 socket fd，供 uv_poll_t、sendfile 及 MSG_ZEROCOPY 使用
+    bool EnsurePollFd();
+    // 等待 socket 可写（在 dup 出的 fd 上使用 uv_poll_t，避免与 stream 句柄冲突）
+    bool WaitWritable();
+    void OnWritable(int status);
+    // 释放发送路径上的辅助资源，连接关闭时调用
+    void ReleaseSendResources();
+    // 释放发送资源并关闭句柄，close 回调中触发 OnClose 并释放连接
+    virtual void CloseHandle();
+    // 关闭内嵌的心跳定时器，在其 close 回调中释放连接对象（句柄 close 回调中调用）
+    void DestroyLater();
+
+    // 入队并触发发送，连接关闭中或队列已满时丢弃
+    void EnqueueSend(SendItem&& item);
+
+    std::queue<SendItem> send_queue_;
     bool is_writing_;
     std::mutex send_mutex_; // 添加发送锁，用于保护send_queue_和is_writing_
     
@@ -58,6 +176,32 @@ protected:
     
     // 接收缓冲区，用于协议解析
     std::vector<char> recv_buffer_;
+    size_t recv_offset_;   // 已处理数据的读偏移，避免每包移动缓冲区
+    size_t recv_need_;     // 未处理数据达到该长度前不再解析
+
+    // 逐连接协议解析器（由 TcpServer 的工厂创建）
+    std::unique_ptr<ConnectionProtocol> protocol_;
+    ConnectionProtocol* EnsureProtocol(); // 按需创建，未设置工厂时返回 nullptr
+    void ParseWithProtocol();
+
+    // sendfile / 可写等待相关
+    SendFileReq* sendfile_req_;  // 正在进行的 sendfile 请求
+    bool close_after_sendfile_;  // 等待线程池中的 sendfile 结束后立即关闭
+    uv_poll_t* writable_poll_;   // 可写事件监听，按需创建
+    int poll_fd_;                // dup 出的 socket fd，供 uv_poll_t 和 sendfile 使用
+
+    // MSG_ZEROCOPY 相关
+    size_t zerocopy_threshold_;
+    int zerocopy_state_;                        // 0 未启用，1 已启用 SO_ZEROCOPY，-1 不支持
+    uint32_t zerocopy_next_seq_;                // 下一个内核完成序号
+    std::list<ZeroCopyBuffer> zerocopy_pending_; // 等待完成通知的缓冲区
+    ZeroCopyBuffer* zerocopy_sending_;          // 正在提交的缓冲区
+    uv_check_t* zerocopy_check_;                // 每轮循环读取完成通知
+    ZeroCopyStats zerocopy_stats_;
+
+    // Cork / 发送合并
+    int cork_depth_;       // Cork 嵌套层数
+    bool flush_scheduled_; // 已登记到本轮循环末尾的批量发送
 };
 
 } // namespace uv_net
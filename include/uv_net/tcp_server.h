@@ -12,8 +12,12 @@
 
 namespace uv_net {
 
+class IoUringLoop;
+
 // TCP Server
 class TcpServer : public Server {
+    friend class IoUringLoop;
+    friend class TcpConnection;
 public:
     TcpServer(uv_loop_t* loop, const ServerConfig& config = ServerConfig());
     ~TcpServer();
@@ -42,6 +46,13 @@ public:
     // 获取协议解析器
     std::shared_ptr<ServerProtocol> GetServerProtocol() const { return server_protocol_; }
 
+    // 逐连接协议解析器工厂，设置后优先于 ServerProtocol，OnMessage 只收到消息体
+    void SetProtocolFactory(ConnectionProtocolFactory factory) { protocol_factory_ = factory; }
+    const ConnectionProtocolFactory& GetProtocolFactory() const { return protocol_factory_; }
+
+    // 所有连接的 MSG_ZEROCOPY 统计汇总
+    const ZeroCopyStats& GetZeroCopyStats() const { return zerocopy_stats_; }
+
     // 内部回调
     virtual void OnNewConnection(std::shared_ptr<Connection> conn);
     virtual void OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len);
@@ -50,11 +61,23 @@ public:
     // 创建连接对象的虚函数，供子类重写
     virtual TcpConnection* CreateConnection(TcpServer* server);
 
+    // 发送合并：登记连接，在本轮循环末尾统一发出
+    void ScheduleFlush(TcpConnection* conn);
+    void CancelFlush(TcpConnection* conn);
+
+protected:
+    // 是否允许使用io_uring传输，依赖uv_tcp_t句柄的子类需返回false
+    virtual bool CanUseIoUring() const { return true; }
+
 private:
+    // 使用io_uring传输启动，失败时返回false由调用方回退到libuv
+    bool StartIoUring(const std::string& ip, int port);
+
     uv_loop_t* loop_;
     std::vector<uv_thread_t> threads_;
     std::vector<uv_loop_t*> loops_;
     std::vector<uv_tcp_t*> listeners_;
+    std::vector<IoUringLoop*> io_uring_loops_;
     
     CallbackOpen on_open_;
     CallbackMessage on_message_;
@@ -65,6 +88,7 @@ private:
     
     // 协议解析器
     std::shared_ptr<ServerProtocol> server_protocol_;
+    ConnectionProtocolFactory protocol_factory_;
     
     // 缓冲区池
     BufferPool buffer_pool_;
@@ -72,6 +96,14 @@ private:
     // 连接计数
     std::atomic<size_t> current_connections_{0}; // 当前连接数
     std::atomic<uint32_t> conn_id_counter_{0}; // 连接ID计数器
+
+    // MSG_ZEROCOPY 统计
+    ZeroCopyStats zerocopy_stats_;
+
+    // 发送合并：uv_check_t 在 poll 之后批量发送，uv_idle_t 保证 poll 不阻塞
+    uv_check_t* flush_check_ = nullptr;
+    uv_idle_t* flush_idle_ = nullptr;
+    std::vector<TcpConnection*> flush_list_;
 };
 
 } // namespace uv_net
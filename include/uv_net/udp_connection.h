@@ -8,18 +8,27 @@ namespace uv_net {
 class UdpServer;
 
 // UDP 伪连接实现
+// 对端第一次发来数据报时创建并登记到所在监听 socket 的会话表，之后的数据报复用同一对象，
+// 空闲超过 ConnectionReadTimeout 或调用 Close 时移出会话表并触发 OnClose
 class UdpConnection : public Connection {
 public:
     UdpServer* server_;
-    uv_udp_t* socket_; // 绑定的 socket，用于发送回复
+    uv_udp_t* socket_; // 用于发送回复的 socket：监听 socket，或热点对端专用的已连接 socket
+    uv_udp_t* listener_; // 收到该对端数据报的监听 socket，会话表所在
+    uv_udp_t* connected_; // 热点对端的已连接 socket（uv_udp_connect），没有为 nullptr
     struct sockaddr_storage addr_;
     std::string ip_;
     int port_;
     uint32_t conn_id_; // 连接ID
+    bool tracked_; // 是否在会话表中，会话表满时创建的临时对象为 false
+    bool connect_failed_; // 创建已连接 socket 失败过，不再尝试
+    uint64_t last_active_; // 最近一次收到数据报的时间（uv_now，毫秒）
+    uint32_t recent_packets_; // 上次过期检查以来收到的数据报数，用于识别热点对端
 
     UdpConnection(UdpServer* server, uv_udp_t* socket, const struct sockaddr* addr);
     ~UdpConnection() override = default;
 
+    using Connection::Send;
     void Send(const char* data, size_t len) override;
     void Close() override;
     std::string GetIP() override;
@@ -5,12 +5,22 @@
 #include "server_config.h"
 #include "udp_connection.h"
 #include "server_protocol.h"
-#include "buffer_pool.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 
 namespace uv_net {
 
+// 批量回调中的一个数据报，addr 与 data 只在回调期间有效
+struct UdpDatagram {
+    const struct sockaddr* addr; // 对端地址
+    const char* data;
+    size_t len;
+};
+
+// 一次 recvmmsg 收到的全部数据报（不创建 UdpConnection）
+using CallbackMessageBatch = std::function<void(const UdpDatagram* datagrams, size_t count)>;
+
 // UDP Server
 class UdpServer : public Server {
 public:
@@ -20,37 +30,106 @@ public:
     void SetOnOpen(CallbackOpen cb) override { on_open_ = cb; }
     void SetOnMessage(CallbackMessage cb) override { on_message_ = cb; }
     void SetOnClose(CallbackClose cb) override { on_close_ = cb; }
+    // 设置后代替 OnMessage：每次 recvmmsg 返回的数据报一次性交付，回复用 SendTo
+    void SetOnMessageBatch(CallbackMessageBatch cb) { on_message_batch_ = cb; }
+
+    // 使用 recvmmsg 一次系统调用接收多个数据报（默认开启，Start 之前设置）
+    void SetRecvMmsg(bool enabled) { recv_mmsg_ = enabled; }
+    bool GetRecvMmsg() const { return recv_mmsg_; }
+    // 内核接收缓冲区 SO_RCVBUF（字节，0 为系统默认），高包速时避免处理间隙内丢包
+    void SetSocketRecvBufferSize(int size) { socket_recv_buffer_size_ = size; }
+    // 工作线程模式：count > 1 时创建 count 个线程，各自运行独立的 loop 和 SO_REUSEPORT 监听 socket（Start 之前设置）
+    // 内核按对端地址与端口的哈希把数据报分给固定的线程，会话表等状态只在所属线程访问；回调在工作线程中执行
+    void SetWorkerCount(int count) { worker_count_ = count; }
+    // 工作线程 i 绑定到 CPU i % CPU数
+    void SetWorkerCpuAffinity(bool enabled) { worker_cpu_affinity_ = enabled; }
+    // 每秒收到的数据报数达到该值的对端，创建专用的已连接 socket（uv_udp_connect）收发，0 为关闭（默认）
+    void SetHotPeerThreshold(uint32_t packets_per_second) { hot_peer_threshold_ = packets_per_second; }
 
     bool Start(const std::string& ip, int port) override;
     void OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len);
+    // 会话移出会话表并触发 OnClose（UdpConnection::Close 调用）
+    void CloseSession(UdpConnection* conn);
+    // 会话表中的对端数
+    size_t GetSessionCount() const { return current_connections_; }
+
+    // 通过监听 socket 向 addr 发送一个数据报：接收回调中使用收到本批数据报的 socket，
+    // 回调之外只能在单线程模式下使用
+    // 默认先 uv_udp_try_send 直接发出，内核缓冲区满时拷贝到池化缓冲区排队；
+    // 配置 SetAutoFlush(true) 时拷贝到本 socket 的待发批次，在本轮循环末尾用 sendmmsg 一次发出
+    void SendTo(const struct sockaddr* addr, const char* data, size_t len);
+    void SendTo(uv_udp_t* socket, const struct sockaddr* addr, const char* data, size_t len);
 
     // 协议解析器设置
     void SetServerProtocol(std::shared_ptr<ServerProtocol> protocol) { server_protocol_ = protocol; }
-    
+
     // 获取协议解析器
     std::shared_ptr<ServerProtocol> GetServerProtocol() const { return server_protocol_; }
-    
+
     // 获取配置（供Connection使用）
     size_t GetReadBufferSize() const { return config_.GetReadBufferSize(); }
+    size_t GetMaxConnections() const { return config_.GetMaxConnections(); }
+    int64_t GetConnectionReadTimeout() const { return config_.GetConnectionReadTimeout(); }
 
 private:
-    uv_loop_t* loop_;                                    // 使用单个loop
-    std::vector<uv_udp_t*> sockets_;
+    struct Socket;
+    struct SendRequest;
+    struct Worker;
+
+    // 创建、绑定监听 socket 并开始接收，失败返回 nullptr
+    Socket* CreateListener(uv_loop_t* loop, const struct sockaddr* addr, bool reuse_port);
+    // 关闭监听 socket 及其会话的已连接 socket
+    void CloseListener(Socket* listener);
+    bool StartWorkers(const struct sockaddr* addr);
+    void StopWorkers();
+    static void WorkerMain(void* arg);
+
+    void DispatchBatch(Socket* socket);
+    // 查找或创建 addr 对应的会话，会话表已满时返回不登记的临时对象
+    std::shared_ptr<UdpConnection> FindSession(Socket* listener, const struct sockaddr* addr);
+    // 定时检查：关闭空闲会话，为热点对端创建已连接 socket
+    void ExpireSessions(Socket* listener);
+    void FinishSession(const std::shared_ptr<UdpConnection>& conn);
+    void ConnectPeer(Socket* listener, UdpConnection* conn);
+    void DisconnectPeer(UdpConnection* conn);
+    // 发出待发批次后关闭 socket 及其定时器，Socket 在关闭回调中释放
+    void CloseSocket(Socket* socket);
+
+    static void AllocCallback(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+    static void RecvCallback(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags);
+    // 循环末尾发送批次：sendmmsg 发出，内核缓冲区满时剩余部分交给 libuv 排队
+    void ScheduleFlush(Socket* socket);
+    void FlushSend(Socket* socket);
+    // 数据（已在池化缓冲区中）交给 uv_udp_send 排队，发送完成后归还
+    void QueueSend(Socket* socket, const struct sockaddr* addr, char* data, size_t len);
+
+    uv_loop_t* loop_;                                    // 单线程模式使用的loop
+    std::vector<Socket*> sockets_;                       // 单线程模式的监听 socket
+    std::vector<Worker*> workers_;                       // 工作线程模式的线程与 loop
+    // 当前线程正在处理的监听 socket，SendTo(addr, ...) 使用
+    static thread_local Socket* current_listener_;
 
     CallbackOpen on_open_;
     CallbackMessage on_message_;
     CallbackClose on_close_;
-    
+    CallbackMessageBatch on_message_batch_;
+
     // 配置
     ServerConfig config_;
-    
+    bool recv_mmsg_;
+    int socket_recv_buffer_size_;
+    uint32_t hot_peer_threshold_;
+    int worker_count_;
+    bool worker_cpu_affinity_;
+
+    // 会话计数
+    std::atomic<size_t> current_connections_{0}; // 当前会话数
+    std::atomic<uint32_t> conn_id_counter_{0}; // 连接ID计数器
+
     // 协议解析器
     std::shared_ptr<ServerProtocol> server_protocol_;
-    
-    // 缓冲区池
-    BufferPool buffer_pool_;
 };
 
 } // namespace uv_net
 
-#endif
\ No newline at end of file
+#endif
@@ -3,7 +3,12 @@
 
 #include "connection.h"
 #include "tcp_connection.h"
+#include "websocket_frame.h"
+#include "websocket_deflate.h"
+#include "simd.h"
+#include <memory>
 #include <queue>
+#include <deque>
 #include <mutex>
 #include <vector>
 #include <cstdint>
@@ -19,15 +24,35 @@ public:
     WebSocketConnection(WebSocketServer* server);
     ~WebSocketConnection() override;
 
-    // 业务调用的 Send
+    using TcpConnection::Send;
+    // 业务调用的 Send，发送文本帧；大于 kDirectWriteThreshold 的载荷与帧头以两段 writev 发出，只拷贝未写完的部分
     void Send(const char* data, size_t len) override;
+    // 多段数据合并为一个帧
+    void Send(const struct iovec* iov, size_t iovcnt) override { Connection::Send(iov, iovcnt); }
+    // 载荷所有权转移进发送队列，帧头单独入队，不拷贝载荷
+    void Send(std::string&& data) override;
+    void Send(Buffer&& buffer) override;
+    // 预留帧头空间的发送缓冲区，SendPackage 原地写入帧头后整块入队
+    SendBuffer NewSendBuffer(size_t capacity) override;
+    void SendPackage(SendBuffer&& buffer) override;
     void Close() override;
 
+    // 以二进制帧发送（Send 系列发送文本帧）
+    void SendBinary(const char* data, size_t len);
+    void SendBinary(Buffer&& buffer);
+    void SendBinary(SendBuffer&& buffer);
+    // 发送预先编码的帧，只引用帧数据，不再编码或拷贝；协商了 permessage-deflate 时优先使用其中的压缩帧
+    void SendPrepared(const PreparedFrame& frame);
+
     // 内部逻辑
+    // 开启分片发送时，写空闲后先把控制帧、再把不超过一个分片大小的数据帧移入发送队列
+    void TrySend() override;
     void OnWriteComplete(int status) override;
     void OnHandshakeComplete();
-    void ParseFrame(const char* data, size_t len);
-    bool ParseHandshake(const std::string& handshake_data);
+    // 从 data 开头解析全部完整的帧，载荷原地解掩码后直接回调，返回消耗的字节数
+    size_t ParseFrames(char* data, size_t len);
+    // 解析 [data, data + head_len) 中的升级请求并应答，返回是否已发出 101 响应
+    bool ParseHandshake(const char* data, size_t head_len);
     void ProcessTextFrame(const char* data, size_t len);
     void ProcessBinaryFrame(const char* data, size_t len);
     void ProcessCloseFrame(const char* data, size_t len);
@@ -35,8 +60,7 @@ public:
     void ProcessPongFrame(const char* data, size_t len);
     void OnDataReceived(const char* data, size_t len) override; // 重写父类的方法，处理WebSocket数据
     
-    // 重写父类的方法
-    void TrySend() override;
+    // 重写父类的方法（发送沿用 TcpConnection::TrySend 的 writev 合并）
     void StartHeartbeat() override;
     void StopHeartbeat() override;
     void OnHeartbeatTimeout() override;
@@ -50,36 +74,104 @@ public:
     };
 
     State state_;
-    std::vector<char> handshake_buffer_;
+    std::vector<char> handshake_buffer_; // 跨多次读取的请求头
+    size_t handshake_scanned_;           // handshake_buffer_ 中已查找过头部结尾的字节数
+
+    // 握手时选定的子协议，未协商时为空
+    const std::string& GetSubprotocol() const { return subprotocol_; }
+    // 是否协商了 permessage-deflate，以及本连接 zlib 状态当前占用的内存（字节）
+    bool IsDeflateEnabled() const { return deflate_ != nullptr; }
+    // 心跳 Ping 测得的往返时延
+    RttStats GetRtt() const override { return rtt_; }
+    size_t GetDeflateMemoryUsage() const { return deflate_ ? deflate_->MemoryUsage() : 0; }
+
+protected:
+    void CloseHandle() override;
 
 private:
-    // WebSocket 帧结构
-    struct WebSocketFrame {
-        bool fin;          // 是否为最终帧
-        uint8_t opcode;    // 操作码
-        bool masked;       // 是否有掩码
-        uint64_t payload_length; // 有效负载长度
-        uint8_t masking_key[4];  // 掩码键
-        const char* payload;      // 有效负载数据
-    };
+    WebSocketServer* GetWebSocketServer() const;
+    void OnFrame(const WebSocketFrame& frame);
+    // 数据帧：未分片的消息原地交付，分片消息重组到 message_buffer_
+    void OnDataFrame(const WebSocketFrame& frame);
+    void DeliverMessage(WebSocketOpcode opcode, const char* data, size_t len);
+    // 流式消息：是否对该帧流式交付、开始一个流式帧、处理该帧已到达的载荷（返回消耗的字节数）
+    bool ShouldStream(const WebSocketFrame& frame) const;
+    void BeginStreamFrame(const WebSocketFrame& frame);
+    size_t StreamPayload(char* data, size_t len);
+    void DeliverChunk(const char* data, size_t len, bool last);
+    void ResetMessage();
+    // 解析握手之后或上次读取残留在 recv_buffer_ 中的帧
+    void ParsePending();
+    void SendPing();
+    void OnRttSample(int64_t rtt_us);
+    // 协议错误：发送关闭帧（RFC 6455 7.4 状态码）后关闭连接
+    void FailConnection(uint16_t code);
+    // 文本消息不是合法的 UTF-8：以 1007 关闭
+    void FailInvalidUtf8();
 
-    // 帧解析状态
-    enum class ParseState {
-        READ_HEADER,
-        READ_PAYLOAD_LENGTH,
-        READ_MASKING_KEY,
-        READ_PAYLOAD
-    };
+    bool handshake_responded_; // 握手响应已发出，等待写完成
 
-    ParseState parse_state_;
-    WebSocketFrame current_frame_;
-    size_t bytes_read_;
-    std::vector<char> buffer_;
+    // 不低于该长度的载荷直接从调用方内存 writev，更小的拷贝入队以便合并发送
+    static const size_t kDirectWriteThreshold = 16 * 1024;
+
+    // 分片消息状态
+    bool in_message_;                 // 分片消息进行中（已收到 fin=0 的首帧）
+    WebSocketOpcode message_opcode_;  // 消息首帧的操作码
+    uint64_t message_size_;           // 已收到的消息字节数
+    std::vector<char> message_buffer_; // 重组缓冲区，取自 WebSocketServer 的缓冲区池
+    bool message_streaming_;          // 消息已转为流式交付
+    bool chunk_first_;                // 下一个片段是否为消息的第一段
+    WebSocketFrame stream_frame_;     // 正在流式接收的帧
+    uint64_t stream_remaining_;       // 该帧尚未到达的载荷字节数
+    uint64_t stream_offset_;          // 该帧已处理的载荷字节数（解掩码偏移）
+    bool message_compressed_;         // 消息首帧带 RSV1，逐帧解压到 message_buffer_
+    Utf8Validator utf8_;              // 分片/流式文本消息的增量 UTF-8 校验
+
+    std::string subprotocol_;
+
+    // 心跳 Ping：载荷为发送时刻（uv_hrtime），对端原样回送
+    uint64_t ping_sent_ns_;  // 未收到 Pong 的 Ping 的时间戳，0 表示没有
+    int missed_pongs_;       // 连续未收到 Pong 的心跳次数
+    RttStats rtt_;
+
+    std::unique_ptr<WebSocketDeflate> deflate_; // 握手协商了 permessage-deflate 时创建
 
     // 辅助方法
-    std::string GenerateResponseKey(const std::string& sec_websocket_key);
-    void SendHandshakeResponse(const std::string& sec_websocket_key);
-    void SendFrame(const char* data, size_t len, uint8_t opcode);
+    void SendHandshakeResponse(const char* data, size_t len);
+    // 握手失败：写出 400/426/431 响应后关闭连接
+    void RejectHandshake(int status);
+    void SendFrame(const char* data, size_t len, WebSocketOpcode opcode);
+    void SendFrame(SendItem&& payload, WebSocketOpcode opcode);
+    void SendFrame(SendBuffer&& buffer, WebSocketOpcode opcode, uint8_t rsv = 0);
+    // permessage-deflate：达到压缩阈值的数据帧压缩后以 RSV1 帧发送，返回是否已发送
+    bool SendCompressed(const char* data, size_t len, WebSocketOpcode opcode);
+    // 业务发送的前置检查：连接已打开且发送队列未满
+    bool CanSend();
+    // 编码好的帧入队并触发发送（帧头与载荷作为相邻的两个元素一起入队）
+    // 开启分片发送时控制帧进入 control_queue_，数据帧进入 outbound_
+    void QueueFrame(SendItem&& item, WebSocketOpcode opcode);
+    void QueueFrame(SendItem&& header, SendItem&& payload);
+    // 开启分片发送时的数据消息入队：超过分片大小的载荷在发送时逐片生成帧
+    void QueueMessage(std::shared_ptr<SendItem> payload, WebSocketOpcode opcode, uint8_t rsv);
+    void StageFrames();
+    bool HasQueuedFrames() const { return !control_queue_.empty() || !outbound_.empty(); }
+
+    // 分片发送的数据消息：已编码的帧（head/body），或按分片大小逐片生成帧的载荷 source
+    struct OutboundMessage {
+        SendItem head;
+        SendItem body;
+        std::shared_ptr<SendItem> source; // 非空时逐片发送，最后一片写完后释放
+        WebSocketOpcode opcode;
+        uint8_t rsv;                      // 只用于第一片
+        size_t offset;                    // 已生成帧的载荷字节数
+
+        OutboundMessage(SendItem&& h, SendItem&& b)
+            : head(std::move(h)), body(std::move(b)), opcode(WebSocketOpcode::BINARY), rsv(0), offset(0) {}
+        OutboundMessage(std::shared_ptr<SendItem> payload, WebSocketOpcode op, uint8_t r)
+            : source(std::move(payload)), opcode(op), rsv(r), offset(0) {}
+    };
+    std::queue<SendItem> control_queue_;   // 待发送的 Ping/Pong/Close，排在所有数据帧之前
+    std::deque<OutboundMessage> outbound_; // 待发送的数据帧，按序逐片移入 send_queue_
 };
 
 } // namespace uv_net
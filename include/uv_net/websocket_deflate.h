@@ -0,0 +1,103 @@
+#ifndef UV_NET_WEBSOCKET_DEFLATE_H
+#define UV_NET_WEBSOCKET_DEFLATE_H
+
+#include "send_buffer.h"
+#include "string_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct z_stream_s;
+
+namespace uv_net {
+
+// permessage-deflate 使用的帧头 RSV1 位（WebSocketFrame::rsv 中的取值）
+static const uint8_t kWebSocketRsv1 = 0x4;
+
+// 服务器端 permessage-deflate 配置（RFC 7692）
+struct WebSocketDeflateOptions {
+    bool enabled = false;
+    // 服务器压缩使用的窗口（9～15），客户端要求更小的窗口时取客户端的值
+    int server_max_window_bits = 15;
+    // 要求客户端使用的窗口（8～15），客户端未声明支持 client_max_window_bits 时只能为 15
+    int client_max_window_bits = 15;
+    // 不保留跨消息的压缩上下文：每条消息独立压缩，消息之间释放 zlib 状态，空闲连接不占用压缩内存
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int compression_level = 6;  // zlib 压缩级别 1～9
+    int mem_level = 8;          // zlib memLevel 1～9，越小内存越少
+    // 小于该长度的消息不压缩
+    size_t min_compress_size = 256;
+};
+
+// 握手协商出的参数
+struct WebSocketDeflateParams {
+    int server_max_window_bits = 15;
+    int client_max_window_bits = 15;
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+};
+
+// 从 Sec-WebSocket-Extensions 中选择第一个可接受的 permessage-deflate 提议
+// 成功时填写 params，并把响应头的值写入 response（如 "permessage-deflate; server_no_context_takeover"）
+bool NegotiateWebSocketDeflate(StringView offers, const WebSocketDeflateOptions& options,
+                               WebSocketDeflateParams& params, std::string& response);
+
+// 用全新的压缩上下文压缩一条完整消息，结果去掉末尾的 00 00 ff ff，追加到 out
+// 不引用之前的任何数据，可以发给任何协商了 permessage-deflate 且服务器窗口不小于 window_bits 的连接
+bool DeflateMessage(const char* data, size_t len, int window_bits, int level, std::string& out);
+
+// 单个连接的压缩/解压状态，zlib 流按需创建
+class WebSocketDeflate {
+public:
+    // memory_total 非空时，zlib 分配的内存同时累加到该计数（服务器内所有连接的总量）
+    WebSocketDeflate(const WebSocketDeflateParams& params, const WebSocketDeflateOptions& options,
+                     size_t* memory_total = nullptr);
+    ~WebSocketDeflate();
+
+    WebSocketDeflate(const WebSocketDeflate&) = delete;
+    WebSocketDeflate& operator=(const WebSocketDeflate&) = delete;
+
+    const WebSocketDeflateParams& Params() const { return params_; }
+    bool ShouldCompress(size_t len) const { return len >= min_compress_size_; }
+
+    // 压缩 len 字节的消息最多需要的输出空间（zlib 对任意参数成立的上界）
+    static size_t CompressBound(size_t len) { return len + (len >> 3) + (len >> 6) + 32; }
+    // 压缩一条完整消息，追加到 out；失败返回 false
+    bool Compress(const char* data, size_t len, SendBuffer& out);
+    // 发送了不经过本连接压缩器的帧（预压缩的 PreparedFrame）后调用，之后的消息不再引用之前的内容
+    // 重置推迟到下一次 Compress，连续发送多个预压缩帧只重置一次
+    void ResetCompressor() { reset_pending_ = deflate_ != nullptr; }
+
+    // 解压消息的一个帧，输出追加到 out；fin 为消息最后一帧
+    // 解压后总长度超过 max_size 时返回 kTooLarge，数据错误返回 kError
+    enum Result { kOk, kError, kTooLarge };
+    Result Decompress(const char* data, size_t len, bool fin, std::vector<char>& out, size_t max_size);
+
+    // zlib 当前分配的内存（字节）
+    size_t MemoryUsage() const { return memory_; }
+
+private:
+    static void* Alloc(void* opaque, unsigned int items, unsigned int size);
+    static void Free(void* opaque, void* address);
+    bool EnsureDeflate();
+    bool EnsureInflate();
+    void ReleaseDeflate();
+    void ReleaseInflate();
+    Result Inflate(const char* data, size_t len, std::vector<char>& out, size_t max_size);
+
+    WebSocketDeflateParams params_;
+    int level_;
+    int mem_level_;
+    size_t min_compress_size_;
+    z_stream_s* deflate_;
+    z_stream_s* inflate_;
+    bool reset_pending_;
+    size_t memory_;
+    size_t* memory_total_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_WEBSOCKET_DEFLATE_H
@@ -0,0 +1,84 @@
+#ifndef UV_NET_WEBSOCKET_FRAME_H
+#define UV_NET_WEBSOCKET_FRAME_H
+
+#include "buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace uv_net {
+
+// WebSocket 操作码（RFC 6455 5.2）
+enum class WebSocketOpcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+// 帧头最大长度：2字节基本头 + 8字节扩展长度 + 4字节掩码
+static const size_t kWebSocketMaxHeaderSize = 14;
+
+// 解析出的帧，payload 指向接收缓冲区中的载荷（原地解掩码）
+struct WebSocketFrame {
+    bool fin;                // 是否为最终帧
+    uint8_t rsv;             // RSV1-3，未协商扩展时必须为 0
+    WebSocketOpcode opcode;  // 操作码
+    bool masked;             // 是否有掩码
+    uint64_t payload_length; // 有效负载长度
+    uint8_t masking_key[4];  // 掩码键
+    char* payload;           // 有效负载数据
+};
+
+inline bool IsControlOpcode(WebSocketOpcode opcode) {
+    return (static_cast<uint8_t>(opcode) & 0x08) != 0;
+}
+
+// 解析 data 开头的帧头，不拷贝数据
+// 返回帧头长度；数据不足返回 0；保留的操作码、分片的控制帧、超长控制帧等协议错误返回 -1
+int ParseWebSocketFrameHeader(const char* data, size_t len, WebSocketFrame& frame);
+
+// 将服务端帧头（不带掩码）写入 out（至少 kWebSocketMaxHeaderSize 字节），返回帧头长度
+size_t EncodeWebSocketFrameHeader(char* out, bool fin, WebSocketOpcode opcode, uint64_t payload_length, uint8_t rsv = 0);
+
+// 预先编码好的服务端帧（帧头 + 载荷），内容不可变，复制只增加引用计数
+// 同一条消息推送给大量连接时只编码、拷贝一次，每个连接的发送队列引用同一块内存
+class PreparedFrame {
+public:
+    PreparedFrame() : block_(nullptr) {}
+    PreparedFrame(const char* data, size_t len, WebSocketOpcode opcode = WebSocketOpcode::BINARY);
+    PreparedFrame(const PreparedFrame& other);
+    PreparedFrame(PreparedFrame&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+    PreparedFrame& operator=(const PreparedFrame& other);
+    PreparedFrame& operator=(PreparedFrame&& other) noexcept;
+    ~PreparedFrame();
+
+    // 同时预先压缩一份 permessage-deflate 帧（RSV1）：整条消息只压缩一次，所有协商了压缩的连接共用
+    // 压缩使用独立的上下文，发给服务器窗口不小于 window_bits 的连接；压缩后不变小时只保留原始帧
+    static PreparedFrame Deflated(const char* data, size_t len, WebSocketOpcode opcode = WebSocketOpcode::BINARY,
+                                  int window_bits = 15, int level = 6);
+
+    bool Empty() const { return block_ == nullptr; }
+    // 完整的帧数据（含帧头）
+    const char* Data() const;
+    size_t Size() const;
+    WebSocketOpcode Opcode() const;
+    // 压缩帧（含帧头），没有压缩帧时 CompressedSize 为 0
+    bool HasCompressed() const { return CompressedSize() > 0; }
+    const char* CompressedData() const;
+    size_t CompressedSize() const;
+    int CompressedWindowBits() const;
+
+    // 引用同一块内存的 Buffer（compressed 为 true 时引用压缩帧），写完成后释放引用
+    Buffer ToBuffer(bool compressed = false) const;
+
+private:
+    struct Block;
+    static Block* NewBlock(size_t size, size_t compressed_size, WebSocketOpcode opcode);
+    Block* block_;
+};
+
+} // namespace uv_net
+
+#endif // UV_NET_WEBSOCKET_FRAME_H
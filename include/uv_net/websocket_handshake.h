@@ -0,0 +1,47 @@
+#ifndef UV_NET_WEBSOCKET_HANDSHAKE_H
+#define UV_NET_WEBSOCKET_HANDSHAKE_H
+
+#include "http_parser.h"
+#include "string_view.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace uv_net {
+
+// Sec-WebSocket-Accept 的长度：SHA-1 摘要（20字节）的 Base64 编码
+static const size_t kWebSocketAcceptSize = 28;
+// 握手请求头的长度上限，超过后不再等待，以 431 拒绝
+static const size_t kWebSocketMaxHandshakeSize = 8192;
+// 101 响应的长度上限（含子协议和扩展）
+static const size_t kWebSocketMaxResponseSize = 512;
+
+// 解析出的升级请求，视图指向请求头所在的缓冲区
+struct WebSocketUpgradeRequest {
+    HttpRequest http;
+    StringView key;        // Sec-WebSocket-Key
+    StringView protocols;  // Sec-WebSocket-Protocol 原始值，逗号分隔
+    StringView extensions; // Sec-WebSocket-Extensions 原始值
+};
+
+// 一次扫描解析并校验升级请求（RFC 6455 4.2.1），[data, data + head_len) 为含空行的完整请求头
+// 头部名称大小写不敏感；成功返回 0，否则返回应答的 HTTP 状态码（400，版本不是 13 时为 426）
+int ParseWebSocketUpgrade(const char* data, size_t head_len, WebSocketUpgradeRequest& req);
+
+// 由 Sec-WebSocket-Key 计算 Sec-WebSocket-Accept，写入 out（kWebSocketAcceptSize 字节，不含结尾 0）
+void ComputeWebSocketAccept(StringView key, char* out);
+
+// 按客户端给出的顺序选择第一个服务器支持的子协议，没有时返回空视图
+StringView SelectWebSocketProtocol(StringView offered, const std::vector<std::string>& supported);
+
+// 将 101 响应写入 out（容量 cap，kWebSocketMaxResponseSize 足够），protocol/extensions 为空时不带对应的头
+// 返回响应长度，容量不足返回 0
+size_t BuildWebSocketHandshakeResponse(char* out, size_t cap, const char* accept, StringView protocol,
+                                       StringView extensions);
+
+// 握手失败的响应（400/426/431），426 时附带 Sec-WebSocket-Version: 13
+size_t BuildWebSocketRejectResponse(char* out, size_t cap, int status);
+
+} // namespace uv_net
+
+#endif // UV_NET_WEBSOCKET_HANDSHAKE_H
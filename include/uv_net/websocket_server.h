@@ -4,15 +4,20 @@
 #include "connection.h"
 #include "server_config.h"
 #include "websocket_connection.h"
+#include "websocket_deflate.h"
 #include "server_protocol.h"
 #include "buffer_pool.h"
 #include "tcp_server.h"
+#include <string>
 #include <vector>
 #include <atomic>
 #include <memory>
 
 namespace uv_net {
 
+// 流式消息回调：大消息按到达的片段依次交付，first/last 标记消息的第一段和最后一段
+using CallbackMessageChunk = std::function<void(std::shared_ptr<Connection>, const char* data, size_t len, bool first, bool last)>;
+
 // WebSocket Server
 class WebSocketServer : public TcpServer {
     friend class WebSocketConnection;
@@ -20,7 +25,33 @@ public:
     WebSocketServer(uv_loop_t* loop, const ServerConfig& config = ServerConfig());
     ~WebSocketServer();
 
-    // WebSocket特有的方法可以在这里添加
+    // 超过 threshold 字节的消息（含分片消息的累计长度）不再重组，按片段交给 OnMessageChunk
+    // 流式消息不受最大包大小限制；未设置回调或 threshold 为 0 时消息完整重组，上限为最大包大小
+    void SetOnMessageChunk(CallbackMessageChunk cb, size_t threshold) {
+        on_message_chunk_ = cb;
+        chunk_threshold_ = threshold;
+    }
+
+    // 握手超时（毫秒），连接建立后在该时间内未完成握手则关闭，0 表示只受心跳超时限制
+    void SetHandshakeTimeout(int64_t timeout_ms) { handshake_timeout_ = timeout_ms; }
+    // 服务器支持的子协议，握手时选择客户端列表中第一个支持的
+    void SetSubprotocols(const std::vector<std::string>& protocols) { subprotocols_ = protocols; }
+    // 心跳发送带时间戳的 Ping，由 Pong 测量往返时延；连续 max_missed_pongs 次心跳未收到对应的 Pong 时关闭连接
+    // 关闭后改为按最近活跃时间判断（两个心跳间隔内无数据则关闭）
+    void SetPingEnabled(bool enabled) { ping_enabled_ = enabled; }
+    void SetMaxMissedPongs(int max_missed_pongs) { max_missed_pongs_ = max_missed_pongs; }
+    // 所有连接的往返时延分布
+    const RttHistogram& GetRttHistogram() const { return rtt_histogram_; }
+
+    // 发送的数据消息超过 size 字节时拆成多个分片帧，分片在发送时才从原缓冲区生成，不拷贝载荷
+    // 开启后 Ping/Pong/Close 插在排队的数据分片之前发出，等待时间不超过一个分片；0 表示不分片（默认）
+    void SetFragmentSize(size_t size) { fragment_size_ = size; }
+    size_t GetFragmentSize() const { return fragment_size_; }
+
+    // permessage-deflate 压缩扩展（RFC 7692），options.enabled 为 false 时不协商
+    void SetDeflateOptions(const WebSocketDeflateOptions& options) { deflate_options_ = options; }
+    // 所有连接的 zlib 压缩/解压状态当前占用的内存（字节）
+    size_t GetDeflateMemoryUsage() const { return deflate_memory_; }
 
 private:
     // 内部回调
@@ -30,6 +61,31 @@ private:
     
     // 重写父类的CreateConnection方法，创建WebSocketConnection对象
     TcpConnection* CreateConnection(TcpServer* server) override;
+
+    // WebSocket连接直接操作uv_tcp_t句柄，不使用io_uring传输
+    bool CanUseIoUring() const override { return false; }
+
+    bool IsStreamingEnabled() const { return on_message_chunk_ && chunk_threshold_ > 0; }
+    void OnMessageChunk(std::shared_ptr<Connection> conn, const char* data, size_t len, bool first, bool last);
+
+    // 分片消息的重组缓冲区在连接间复用，保留的容量受最大包大小限制
+    std::vector<char> AcquireMessageBuffer();
+    void ReleaseMessageBuffer(std::vector<char>&& buffer);
+
+    static const int64_t kDefaultHandshakeTimeout = 10000;
+    static const int kDefaultMaxMissedPongs = 2;
+    int64_t handshake_timeout_;
+    std::vector<std::string> subprotocols_;
+    bool ping_enabled_;
+    int max_missed_pongs_;
+    RttHistogram rtt_histogram_;
+    WebSocketDeflateOptions deflate_options_;
+    size_t deflate_memory_;
+    CallbackMessageChunk on_message_chunk_;
+    size_t chunk_threshold_;
+    size_t fragment_size_;
+    std::vector<std::vector<char>> message_buffers_;
+    static const size_t kMaxPooledMessageBuffers = 64;
 };
 
 } // namespace uv_net
@@ -0,0 +1,168 @@
+#include "uv_net/http_parser.h"
+#include "uv_net/simd.h"
+
+namespace uv_net {
+
+static const size_t kMaxContentLength = static_cast<size_t>(1) << 40;
+
+static StringView TrimSpaces(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        ++begin;
+    }
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+        --end;
+    }
+    return StringView(begin, static_cast<size_t>(end - begin));
+}
+
+StringView HttpRequest::GetHeader(StringView name) const {
+    for (size_t i = 0; i < header_count; ++i) {
+        if (headers[i].name.EqualsIgnoreCase(name)) {
+            return headers[i].value;
+        }
+    }
+    return StringView();
+}
+
+size_t HttpParser::FindHeadEnd(const char* data, size_t len, size_t from) {
+    const char* end = data + len;
+    const char* p = data + from;
+    // 头部以空行结束：换行后紧跟 "\r\n" 或 "\n"
+    while (p < end) {
+        const char* lf = FindByte(p, end, '\n');
+        if (lf == end) {
+            break;
+        }
+        const char* next = lf + 1;
+        if (next < end && *next == '\n') {
+            return static_cast<size_t>(next + 1 - data);
+        }
+        if (next + 1 < end && next[0] == '\r' && next[1] == '\n') {
+            return static_cast<size_t>(next + 2 - data);
+        }
+        p = next;
+    }
+    return 0;
+}
+
+bool HttpParser::ParseHead(const char* data, size_t head_len, HttpRequest& req) {
+    const char* p = data;
+    const char* end = data + head_len;
+
+    // 请求行：METHOD SP TARGET SP HTTP/1.x
+    const char* lf = FindByte(p, end, '\n');
+    if (lf == end) {
+        return false;
+    }
+    const char* line_end = (lf > p && lf[-1] == '\r') ? lf - 1 : lf;
+    const char* sp1 = FindByte(p, line_end, ' ');
+    if (sp1 == line_end || sp1 == p) {
+        return false;
+    }
+    const char* sp2 = FindByte(sp1 + 1, line_end, ' ');
+    if (sp2 == line_end || sp2 == sp1 + 1) {
+        return false;
+    }
+    req.method = StringView(p, static_cast<size_t>(sp1 - p));
+    req.target = StringView(sp1 + 1, static_cast<size_t>(sp2 - sp1 - 1));
+    StringView version(sp2 + 1, static_cast<size_t>(line_end - sp2 - 1));
+    if (version.Size() != 8 || memcmp(version.Data(), "HTTP/1.", 7) != 0 || version[7] < '0' || version[7] > '9') {
+        return false;
+    }
+    req.minor_version = version[7] - '0';
+
+    const char* question = FindByte(req.target.Data(), req.target.Data() + req.target.Size(), '?');
+    req.path = StringView(req.target.Data(), static_cast<size_t>(question - req.target.Data()));
+    if (question < req.target.Data() + req.target.Size()) {
+        req.query = StringView(question + 1, static_cast<size_t>(req.target.Data() + req.target.Size() - question - 1));
+    } else {
+        req.query = StringView();
+    }
+
+    // 头部：NAME ":" OWS VALUE OWS
+    req.header_count = 0;
+    req.content_length = 0;
+    req.keep_alive = req.minor_version >= 1;
+    p = lf + 1;
+    bool has_content_length = false;
+    while (p < end) {
+        lf = FindByte(p, end, '\n');
+        line_end = (lf > p && lf[-1] == '\r') ? lf - 1 : lf;
+        if (line_end == p) {
+            break; // 空行，头部结束
+        }
+        const char* colon = FindByte(p, line_end, ':');
+        if (colon == line_end || colon == p || req.header_count >= HttpRequest::kMaxHeaders) {
+            return false;
+        }
+        HttpHeader& header = req.headers[req.header_count++];
+        header.name = StringView(p, static_cast<size_t>(colon - p));
+        header.value = TrimSpaces(colon + 1, line_end);
+
+        // 先按长度过滤，多数头部无需逐字符比较
+        size_t name_len = header.name.Size();
+        if (name_len == 14 && header.name.EqualsIgnoreCase(StringView("Content-Length", 14))) {
+            size_t value = 0;
+            if (header.value.Empty()) {
+                return false;
+            }
+            for (size_t i = 0; i < header.value.Size(); ++i) {
+                char c = header.value[i];
+                if (c < '0' || c > '9' || value > kMaxContentLength) {
+                    return false;
+                }
+                value = value * 10 + static_cast<size_t>(c - '0');
+            }
+            // RFC 9112 §6.3：多个 Content-Length 取值不一致时必须拒绝，否则可被用于请求走私
+            if (has_content_length && value != req.content_length) {
+                return false;
+            }
+            has_content_length = true;
+            req.content_length = value;
+        } else if (name_len == 17 && header.name.EqualsIgnoreCase(StringView("Transfer-Encoding", 17))) {
+            return false;
+        } else if (name_len == 10 && header.name.EqualsIgnoreCase(StringView("Connection", 10))) {
+            if (header.value.EqualsIgnoreCase("close")) {
+                req.keep_alive = false;
+            } else if (header.value.EqualsIgnoreCase("keep-alive")) {
+                req.keep_alive = true;
+            }
+        }
+        p = lf + 1;
+    }
+    return true;
+}
+
+PackageStatus HttpProtocol::Parse(const char* buff, size_t len, PackageInfo& info) {
+    if (head_len_ == 0) {
+        // 从上次扫描位置之前两个字节继续，避免漏掉跨读取边界的空行
+        size_t from = scanned_ > 2 ? scanned_ - 2 : 0;
+        head_len_ = HttpParser::FindHeadEnd(buff, len, from);
+        if (head_len_ == 0) {
+            scanned_ = len;
+            info.need_len = 1;
+            return PackageLess;
+        }
+    }
+
+    // 缓冲区在两次调用之间可能移动，视图每次重新生成
+    if (!HttpParser::ParseHead(buff, head_len_, request_)) {
+        return PackageError;
+    }
+
+    size_t total = head_len_ + request_.content_length;
+    if (len < total) {
+        info.need_len = total - len;
+        return PackageLess;
+    }
+
+    request_.body = StringView(buff + head_len_, request_.content_length);
+    info.package_len = total;
+    info.payload_offset = 0;
+    info.payload_len = total;
+    scanned_ = 0;
+    head_len_ = 0;
+    return PackageFull;
+}
+
+} // namespace uv_net
@@ -0,0 +1,144 @@
+#include "uv_net/http_server.h"
+#include "uv_net/tcp_connection.h"
+#include <plog/Log.h>
+#include <cstdio>
+
+namespace uv_net {
+
+static const char* ReasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+// HttpServer 依赖发送合并让 pipelining 的响应批量发出
+static ServerConfig HttpServerConfig(const ServerConfig& config) {
+    ServerConfig http_config = config;
+    http_config.SetAutoFlush(true);
+    return http_config;
+}
+
+HttpResponse::HttpResponse(std::shared_ptr<Connection> conn, const HttpRequest& req)
+    : conn_(std::move(conn)), minor_version_(req.minor_version), keep_alive_(req.keep_alive),
+      head_request_(req.method == "HEAD"), ended_(false), status_(200), reason_(nullptr), body_data_(nullptr), body_len_(0), body_owned_(false) {
+}
+
+void HttpResponse::SetStatus(int code, const char* reason) {
+    status_ = code;
+    reason_ = reason;
+}
+
+void HttpResponse::AddHeader(StringView name, StringView value) {
+    head_.append(name.Data(), name.Size());
+    head_.append(": ", 2);
+    head_.append(value.Data(), value.Size());
+    head_.append("\r\n", 2);
+}
+
+void HttpResponse::SetBody(const char* data, size_t len) {
+    body_data_ = data;
+    body_len_ = len;
+    body_owned_ = false;
+}
+
+void HttpResponse::SetBody(std::string&& body) {
+    body_ = std::move(body);
+    body_owned_ = true;
+}
+
+void HttpResponse::End() {
+    if (ended_) {
+        return;
+    }
+    ended_ = true;
+
+    size_t body_len = body_owned_ ? body_.size() : body_len_;
+    const char* reason = reason_ ? reason_ : ReasonPhrase(status_);
+
+    // RFC 9110：1xx/204/304 不能带包体和 Content-Length；HEAD 保留 Content-Length 但不发送包体
+    bool no_content = (status_ >= 100 && status_ < 200) || status_ == 204 || status_ == 304;
+    bool send_body = !no_content && !head_request_ && body_len > 0;
+
+    // 状态行与固定头部在栈上格式化，用户头部追加在后
+    char length[48] = "";
+    if (!no_content) {
+        snprintf(length, sizeof(length), "Content-Length: %zu\r\n", body_len);
+    }
+    char line[192];
+    int n = snprintf(line, sizeof(line), "HTTP/1.%d %d %s\r\n%s%s",
+                     minor_version_, status_, reason, length,
+                     keep_alive_ ? (minor_version_ == 0 ? "Connection: keep-alive\r\n" : "") : "Connection: close\r\n");
+    if (n < 0 || static_cast<size_t>(n) >= sizeof(line)) {
+        n = snprintf(line, sizeof(line), "HTTP/1.%d %d Unknown\r\n%sConnection: close\r\n",
+                     minor_version_, status_, length);
+        keep_alive_ = false;
+    }
+    std::string head;
+    head.reserve(static_cast<size_t>(n) + head_.size() + 2);
+    head.append(line, static_cast<size_t>(n));
+    head.append(head_);
+    head.append("\r\n", 2);
+
+    if (body_owned_) {
+        // 头部与包体都转移进发送队列，Cork 保证合并为一次 writev
+        conn_->Cork();
+        conn_->Send(std::move(head));
+        if (send_body) {
+            conn_->Send(std::move(body_));
+        }
+        conn_->Uncork();
+    } else {
+        struct iovec iov[2];
+        iov[0].iov_base = const_cast<char*>(head.data());
+        iov[0].iov_len = head.size();
+        iov[1].iov_base = const_cast<char*>(body_data_);
+        iov[1].iov_len = body_len_;
+        conn_->Send(iov, send_body ? 2 : 1);
+    }
+
+    if (!keep_alive_) {
+        conn_->Close();
+    }
+}
+
+HttpServer::HttpServer(uv_loop_t* loop, const ServerConfig& config) : TcpServer(loop, HttpServerConfig(config)) {
+    SetProtocolFactory([] { return std::unique_ptr<ConnectionProtocol>(new HttpProtocol()); });
+    PLOG_INFO << "HTTP Server created with buffer pool size: " << config.GetReadBufferSize();
+}
+
+HttpServer::~HttpServer() {
+    PLOG_INFO << "HTTP Server destroying";
+    // 基类的析构函数会处理资源释放
+    PLOG_INFO << "HTTP Server destroyed";
+}
+
+void HttpServer::OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len) {
+    // 请求已由连接上的 HttpProtocol 解析，视图指向本次回调的数据
+    TcpConnection* tcp_conn = static_cast<TcpConnection*>(conn.get());
+    const HttpRequest& req = static_cast<HttpProtocol*>(tcp_conn->GetProtocol())->GetRequest();
+
+    HttpResponse resp(conn, req);
+    if (on_request_) {
+        on_request_(conn, req, resp);
+    } else {
+        resp.SetStatus(404);
+    }
+    resp.End();
+}
+
+} // namespace uv_net
@@ -0,0 +1,724 @@
+#include "uv_net/io_uring_transport.h"
+#include "uv_net/tcp_server.h"
+#include <plog/Log.h>
+
+#ifdef UV_NET_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+
+namespace uv_net {
+
+static int IoUringSetup(unsigned entries, struct io_uring_params* p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int IoUringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+static size_t PageAlign(size_t size) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (size + page - 1) & ~(page - 1);
+}
+
+// ---------------------------------------------------------------------------
+// IoUringLoop
+// ---------------------------------------------------------------------------
+
+IoUringLoop::IoUringLoop(uv_loop_t* loop, TcpServer* server)
+    : loop_(loop), server_(server), ring_fd_(-1), listen_fd_(-1),
+      ring_ptr_(nullptr), ring_size_(0), sqes_(nullptr), sqes_size_(0),
+      sq_head_(nullptr), sq_tail_(nullptr), sq_array_(nullptr), sq_mask_(0), sq_entries_(0),
+      cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0), cqes_(nullptr),
+      sqe_tail_(0), sqe_submitted_(0),
+      buf_ring_(nullptr), buf_ring_size_(0), buffers_(nullptr),
+      buffer_count_(0), buffer_size_(0), buf_tail_(0),
+      poll_handle_(nullptr), prepare_handle_(nullptr) {
+    accept_op_.type = IoUringOp::Type::ACCEPT;
+    accept_op_.conn = nullptr;
+}
+
+IoUringLoop::~IoUringLoop() {
+    PLOG_INFO << "io_uring transport destroying";
+    // 停止接受新连接，之后到达的 accept 完成事件直接关闭 fd
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    ShutdownConnections();
+    if (poll_handle_) {
+        uv_close((uv_handle_t*)poll_handle_, [](uv_handle_t* h) { delete (uv_poll_t*)h; });
+    }
+    if (prepare_handle_) {
+        uv_close((uv_handle_t*)prepare_handle_, [](uv_handle_t* h) { delete (uv_prepare_t*)h; });
+    }
+    // 关闭 ring fd 会取消所有未完成的请求
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+    }
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (ring_ptr_) {
+        munmap(ring_ptr_, ring_size_);
+    }
+    if (buf_ring_) {
+        munmap(buf_ring_, buf_ring_size_);
+    }
+    delete[] buffers_;
+}
+
+void IoUringLoop::ShutdownConnections() {
+    if (connections_.empty()) {
+        return;
+    }
+    PLOG_INFO << "io_uring transport closing " << connections_.size() << " connections";
+
+    // shutdown 让未完成的 send 以错误结束、multishot recv 以 0 字节结束，不会无限等待对端
+    std::vector<IoUringConnection*> conns(connections_.begin(), connections_.end());
+    for (IoUringConnection* conn : conns) {
+        shutdown(conn->fd_, SHUT_RDWR);
+        conn->StopHeartbeat();
+        conn->BeginShutdown();
+    }
+
+    // 同步等待 ring 上的请求全部完成，连接随之释放 fd 并触发 OnClose
+    for (;;) {
+        bool pending = false;
+        for (IoUringConnection* conn : connections_) {
+            if (conn->pending_ops_ > 0) {
+                pending = true;
+                break;
+            }
+        }
+        if (!pending) {
+            break;
+        }
+        Submit();
+        if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            PLOG_ERROR << "io_uring wait failed during shutdown: " << strerror(errno);
+            break;
+        }
+        ReapCompletions();
+    }
+
+    // 线程池中的 sendfile 尚未结束的连接在其完成回调中释放，此后不再访问 ring 与 server
+    for (IoUringConnection* conn : connections_) {
+        conn->ring_ = nullptr;
+        conn->server_ = nullptr;
+    }
+    connections_.clear();
+}
+
+bool IoUringLoop::IsSupported() {
+    // multishot recv 需要 6.0 以上内核
+    struct utsname uts;
+    if (uname(&uts) != 0) {
+        return false;
+    }
+    int major = 0, minor = 0;
+    if (sscanf(uts.release, "%d.%d", &major, &minor) != 2 || major < 6) {
+        return false;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = IoUringSetup(4, &params);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool supported = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    // 通过 probe 确认 accept/recv/send/cancel 操作码可用
+    if (supported) {
+        size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+        struct io_uring_probe* probe = static_cast<struct io_uring_probe*>(calloc(1, probe_size));
+        if (IoUringRegister(fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+            const uint8_t ops[] = { IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_ASYNC_CANCEL };
+            for (uint8_t op : ops) {
+                if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                    supported = false;
+                }
+            }
+        } else {
+            supported = false;
+        }
+        free(probe);
+    }
+
+    close(fd);
+    return supported;
+}
+
+bool IoUringLoop::Init(unsigned queue_depth, unsigned buffer_count, unsigned buffer_size) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = queue_depth * 4;
+
+    ring_fd_ = IoUringSetup(queue_depth, &params);
+    if (ring_fd_ < 0) {
+        PLOG_ERROR << "io_uring setup failed: " << strerror(errno);
+        return false;
+    }
+
+    // 映射 SQ/CQ ring（要求 IORING_FEAT_SINGLE_MMAP）
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring_size_ = sq_size > cq_size ? sq_size : cq_size;
+    ring_ptr_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ptr_ == MAP_FAILED) {
+        ring_ptr_ = nullptr;
+        PLOG_ERROR << "io_uring ring mmap failed: " << strerror(errno);
+        return false;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        PLOG_ERROR << "io_uring sqes mmap failed: " << strerror(errno);
+        return false;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    char* base = static_cast<char*>(ring_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    cq_head_ = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(base + params.cq_off.cqes);
+    sqe_tail_ = sqe_submitted_ = *sq_tail_;
+
+    // 注册 provided buffer ring，数量必须是2的幂
+    if (buffer_count == 0 || (buffer_count & (buffer_count - 1)) != 0 || buffer_count > 32768) {
+        PLOG_ERROR << "io_uring buffer count must be a power of 2 (<= 32768): " << buffer_count;
+        return false;
+    }
+    buffer_count_ = buffer_count;
+    buffer_size_ = buffer_size;
+    buf_ring_size_ = PageAlign(buffer_count_ * sizeof(struct io_uring_buf));
+    void* br = mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (br == MAP_FAILED) {
+        PLOG_ERROR << "io_uring buffer ring mmap failed: " << strerror(errno);
+        return false;
+    }
+    buf_ring_ = static_cast<struct io_uring_buf_ring*>(br);
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = buffer_count_;
+    reg.bgid = 0;
+    if (IoUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        PLOG_ERROR << "io_uring register buffer ring failed: " << strerror(errno);
+        return false;
+    }
+
+    buffers_ = new char[static_cast<size_t>(buffer_count_) * buffer_size_];
+    for (unsigned i = 0; i < buffer_count_; ++i) {
+        RecycleBuffer(static_cast<uint16_t>(i));
+    }
+
+    // ring fd 可读表示 CQ 中有完成事件
+    poll_handle_ = new uv_poll_t();
+    uv_poll_init(loop_, poll_handle_, ring_fd_);
+    poll_handle_->data = this;
+    uv_poll_start(poll_handle_, UV_READABLE, [](uv_poll_t* handle, int status, int events) {
+        IoUringLoop* ring = static_cast<IoUringLoop*>(handle->data);
+        ring->ReapCompletions();
+    });
+
+    // 每轮循环进入 poll 之前批量提交本轮产生的 SQE
+    prepare_handle_ = new uv_prepare_t();
+    uv_prepare_init(loop_, prepare_handle_);
+    prepare_handle_->data = this;
+    uv_prepare_start(prepare_handle_, [](uv_prepare_t* handle) {
+        IoUringLoop* ring = static_cast<IoUringLoop*>(handle->data);
+        ring->Submit();
+    });
+
+    PLOG_INFO << "io_uring transport initialized, sq entries: " << sq_entries_ << ", buffers: " << buffer_count_ << "x" << buffer_size_;
+    return true;
+}
+
+bool IoUringLoop::Listen(const std::string& ip, int port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        PLOG_ERROR << "io_uring listen socket failed: " << strerror(errno);
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#ifdef SO_REUSEPORT
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+#endif
+
+    struct sockaddr_in addr;
+    uv_ip4_addr(ip.c_str(), port, &addr);
+    if (bind(listen_fd_, (const struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd_, 128) != 0) {
+        PLOG_ERROR << "io_uring bind/listen failed on " << ip << ":" << port << ": " << strerror(errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    ArmAccept();
+    Submit();
+    return true;
+}
+
+struct io_uring_sqe* IoUringLoop::GetSqe() {
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_) {
+        // SQ 已满，先提交一批
+        Submit();
+        head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (sqe_tail_ - head >= sq_entries_) {
+            return nullptr;
+        }
+    }
+    struct io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[sqe_tail_ & sq_mask_] = sqe_tail_ & sq_mask_;
+    sqe_tail_++;
+    return sqe;
+}
+
+void IoUringLoop::Submit() {
+    unsigned to_submit = sqe_tail_ - sqe_submitted_;
+    if (to_submit == 0) {
+        return;
+    }
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    sqe_submitted_ = sqe_tail_;
+
+    while (to_submit > 0) {
+        int r = IoUringEnter(ring_fd_, to_submit, 0, 0);
+        if (r >= 0) {
+            to_submit -= static_cast<unsigned>(r);
+            if (r == 0) {
+                break;
+            }
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EBUSY || errno == EAGAIN) {
+            // CQ 积压，先处理完成事件
+            ReapCompletions();
+        } else {
+            PLOG_ERROR << "io_uring submit failed: " << strerror(errno);
+            break;
+        }
+    }
+}
+
+void IoUringLoop::ReapCompletions() {
+    for (;;) {
+        // 每次都重新读取 head：回调中 Submit 遇到 EBUSY 会重入本函数并消费后续完成事件
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            break;
+        }
+        struct io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+        IoUringOp* op = reinterpret_cast<IoUringOp*>(cqe->user_data);
+        int res = cqe->res;
+        uint32_t flags = cqe->flags;
+        head++;
+        // 先归还 CQE 槽位，回调中可能继续提交请求
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+        switch (op->type) {
+            case IoUringOp::Type::ACCEPT:
+                HandleAccept(res, flags);
+                break;
+            case IoUringOp::Type::RECV:
+                HandleRecv(op->conn, res, flags);
+                break;
+            case IoUringOp::Type::SEND:
+                HandleSend(op->conn, res);
+                break;
+            case IoUringOp::Type::CANCEL:
+                op->conn->pending_ops_--;
+                op->conn->MaybeFinalize();
+                break;
+        }
+    }
+}
+
+void IoUringLoop::ArmAccept() {
+    struct io_uring_sqe* sqe = GetSqe();
+    if (!sqe) {
+        PLOG_ERROR << "io_uring submission queue full, accept not armed";
+        return;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = reinterpret_cast<uint64_t>(&accept_op_);
+}
+
+void IoUringLoop::ArmRecv(IoUringConnection* conn) {
+    struct io_uring_sqe* sqe = GetSqe();
+    if (!sqe) {
+        PLOG_ERROR << "io_uring submission queue full, closing connection " << conn->conn_id_;
+        conn->Close();
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->user_data = reinterpret_cast<uint64_t>(&conn->recv_op_);
+    conn->recv_armed_ = true;
+    conn->pending_ops_++;
+}
+
+void IoUringLoop::ArmSend(IoUringConnection* conn) {
+    struct io_uring_sqe* sqe = GetSqe();
+    if (!sqe) {
+        PLOG_ERROR << "io_uring submission queue full, closing connection " << conn->conn_id_;
+        conn->is_writing_ = false;
+        conn->BeginShutdown();
+        return;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(conn->sending_.Data() + conn->send_offset_);
+    sqe->len = static_cast<uint32_t>(conn->sending_.Size() - conn->send_offset_);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(&conn->send_op_);
+    conn->pending_ops_++;
+}
+
+void IoUringLoop::CancelRecv(IoUringConnection* conn) {
+    struct io_uring_sqe* sqe = GetSqe();
+    if (!sqe) {
+        // 无法取消时直接 shutdown socket，multishot recv 会以 0 字节结束
+        shutdown(conn->fd_, SHUT_RDWR);
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = reinterpret_cast<uint64_t>(&conn->recv_op_);
+    sqe->user_data = reinterpret_cast<uint64_t>(&conn->cancel_op_);
+    conn->pending_ops_++;
+}
+
+void IoUringLoop::RecycleBuffer(uint16_t bid) {
+    // 不使用 buf_ring_->bufs：内核头文件中的柔性数组在 C++ 下会多出一个空结构体成员导致偏移错误
+    struct io_uring_buf* bufs = reinterpret_cast<struct io_uring_buf*>(buf_ring_);
+    struct io_uring_buf* buf = &bufs[buf_tail_ & (buffer_count_ - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(bid) * buffer_size_);
+    buf->len = buffer_size_;
+    buf->bid = bid;
+    buf_tail_++;
+    __atomic_store_n(&buf_ring_->tail, buf_tail_, __ATOMIC_RELEASE);
+}
+
+void IoUringLoop::HandleAccept(int res, uint32_t flags) {
+    // 已停止监听（析构中）
+    if (listen_fd_ < 0) {
+        if (res >= 0) {
+            close(res);
+        }
+        return;
+    }
+
+    // multishot accept 终止后重新投递
+    if (!(flags & IORING_CQE_F_MORE)) {
+        ArmAccept();
+    }
+
+    if (res < 0) {
+        PLOG_ERROR << "io_uring accept error: " << strerror(-res);
+        return;
+    }
+
+    int fd = res;
+    // 检查连接数是否已达上限
+    if (server_->current_connections_ >= server_->GetMaxConnections()) {
+        PLOG_WARNING << "TCP Server connection limit reached: " << server_->GetMaxConnections();
+        close(fd);
+        return;
+    }
+
+    // 设置socket选项
+    int read_buf_size = static_cast<int>(server_->GetConfig().GetReadBufferSize());
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &read_buf_size, sizeof(read_buf_size));
+    int write_buf_size = static_cast<int>(server_->GetConfig().GetWriteBufferSize());
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &write_buf_size, sizeof(write_buf_size));
+    int no_delay = server_->GetConfig().GetTcpNoDelay() ? 1 : 0;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+    IoUringConnection* conn = new IoUringConnection(server_, this, fd);
+    struct sockaddr_storage peer;
+    socklen_t namelen = sizeof(peer);
+    if (getpeername(fd, (struct sockaddr*)&peer, &namelen) == 0 && peer.ss_family == AF_INET) {
+        conn->ip_ = inet_ntoa(((struct sockaddr_in*)&peer)->sin_addr);
+        conn->port_ = ntohs(((struct sockaddr_in*)&peer)->sin_port);
+    } else {
+        conn->ip_ = "Unknown";
+    }
+    conn->conn_id_ = server_->conn_id_counter_++;
+    connections_.insert(conn);
+
+    PLOG_INFO << "TCP Server (io_uring) accepted connection from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << ")";
+
+    ArmRecv(conn);
+    conn->StartHeartbeat();
+
+    std::shared_ptr<Connection> shared_conn(conn, [](TcpConnection*){});
+    server_->OnNewConnection(shared_conn);
+}
+
+void IoUringLoop::HandleRecv(IoUringConnection* conn, int res, uint32_t flags) {
+    bool more = (flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        conn->recv_armed_ = false;
+        conn->pending_ops_--;
+    }
+
+    if (res > 0) {
+        uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (!conn->is_closing_) {
+            PLOG_INFO << "TCP Server received " << res << " bytes from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << ")";
+            conn->OnDataReceived(buffers_ + static_cast<size_t>(bid) * buffer_size_, static_cast<size_t>(res));
+        }
+        // 数据已被协议层消费或拷贝，立即归还缓冲区
+        RecycleBuffer(bid);
+        if (!more && !conn->is_closing_) {
+            ArmRecv(conn);
+        }
+    } else if (res == -ENOBUFS) {
+        // 缓冲区暂时耗尽，重新投递
+        PLOG_WARNING << "io_uring recv buffers exhausted (ConnId: " << conn->conn_id_ << ")";
+        if (!more && !conn->is_closing_) {
+            ArmRecv(conn);
+        }
+    } else if (res != -ECANCELED) {
+        if (res < 0 && res != -ECONNRESET) {
+            PLOG_ERROR << "TCP Server read error from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << "):" << strerror(-res);
+        }
+        PLOG_INFO << "TCP Server connection closed from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << ")";
+        // 对端关闭，丢弃未发送数据
+        conn->StopHeartbeat();
+        conn->BeginShutdown();
+    }
+
+    conn->MaybeFinalize();
+}
+
+void IoUringLoop::HandleSend(IoUringConnection* conn, int res) {
+    conn->pending_ops_--;
+
+    if (res < 0) {
+        conn->sending_ = IoUringConnection::SendItem();
+        conn->OnWriteComplete(res == -ECANCELED ? UV_ECANCELED : -EPIPE);
+    } else {
+        conn->send_offset_ += static_cast<size_t>(res);
+        if (conn->send_offset_ < conn->sending_.Size() && !conn->finalized_) {
+            // 部分发送，继续发送剩余数据
+            ArmSend(conn);
+        } else {
+            conn->sending_ = IoUringConnection::SendItem();
+            conn->OnWriteComplete(0);
+        }
+    }
+
+    conn->MaybeFinalize();
+}
+
+// ---------------------------------------------------------------------------
+// IoUringConnection
+// ---------------------------------------------------------------------------
+
+IoUringConnection::IoUringConnection(TcpServer* server, IoUringLoop* ring, int fd)
+    : TcpConnection(server), ring_(ring), fd_(fd), pending_ops_(0),
+      recv_armed_(false), finalized_(false), send_offset_(0) {
+    recv_op_.type = IoUringOp::Type::RECV;
+    recv_op_.conn = this;
+    send_op_.type = IoUringOp::Type::SEND;
+    send_op_.conn = this;
+    cancel_op_.type = IoUringOp::Type::CANCEL;
+    cancel_op_.conn = this;
+}
+
+IoUringConnection::~IoUringConnection() {
+}
+
+uv_loop_t* IoUringConnection::GetLoop() {
+    return ring_->loop_;
+}
+
+void IoUringConnection::TrySend() {
+    // 如果正在发送、队列为空或处于 Cork 状态，直接返回
+    if (is_writing_ || send_queue_.empty() || is_closing_ || cork_depth_ > 0) {
+        return;
+    }
+
+    // 文件区间复用 TcpConnection 的 sendfile 路径
+    if (send_queue_.front().IsFile()) {
+        SendItem item = std::move(send_queue_.front());
+        send_queue_.pop();
+        is_writing_ = true;
+        StartSendFile(std::move(item));
+        return;
+    }
+
+    sending_ = std::move(send_queue_.front());
+    send_queue_.pop();
+    send_offset_ = 0;
+    is_writing_ = true;
+
+    PLOG_INFO << "TCP Connection " << conn_id_ << " sending " << sending_.Size() << " bytes";
+
+    // SQE 在本轮循环末尾与其他请求一起批量提交
+    ring_->ArmSend(this);
+}
+
+void IoUringConnection::OnWriteComplete(int status) {
+    is_writing_ = false;
+
+    if (status < 0) {
+        if (status != UV_ECANCELED) {
+            PLOG_ERROR << "TCP Connection " << conn_id_ << " write failed: " << uv_strerror(status);
+        }
+        StopHeartbeat();
+        BeginShutdown();
+        return;
+    }
+
+    PLOG_INFO << "TCP Connection " << conn_id_ << " write complete";
+    last_active_time_ = uv_now(uv_default_loop());
+
+    TrySend();
+
+    // 检查是否需要优雅关闭
+    if (is_closing_gracefully_ && send_queue_.empty() && !is_writing_) {
+        PLOG_INFO << "TCP Connection " << conn_id_ << " send queue empty, closing gracefully";
+        BeginShutdown();
+    }
+}
+
+void IoUringConnection::Close() {
+    if (is_closing_ || is_closing_gracefully_) {
+        return;
+    }
+
+    StopHeartbeat();
+
+    if (send_queue_.empty() && !is_writing_) {
+        PLOG_INFO << "TCP Connection " << conn_id_ << " closing immediately";
+        BeginShutdown();
+    } else {
+        // 发送队列不为空，执行优雅关闭
+        is_closing_gracefully_ = true;
+        PLOG_INFO << "TCP Connection " << conn_id_ << " closing gracefully";
+        cork_depth_ = 0;
+        TrySend();
+    }
+}
+
+void IoUringConnection::BeginShutdown() {
+    if (is_closing_) {
+        return;
+    }
+    is_closing_ = true;
+
+    if (recv_armed_) {
+        ring_->CancelRecv(this);
+    }
+    // 等待可写的 sendfile 直接结束；线程池中执行的 sendfile 在完成回调中结束，此前保持 poll_fd_ 打开
+    if (sendfile_req_ && !sendfile_req_->running) {
+        FinishSendFile(UV_ECANCELED);
+    }
+    MaybeFinalize();
+}
+
+void IoUringConnection::CloseImmediately() {
+    StopHeartbeat();
+    BeginShutdown();
+    // 已在关闭中时 BeginShutdown 直接返回，这里检查是否可以释放
+    MaybeFinalize();
+}
+
+void IoUringConnection::MaybeFinalize() {
+    if (!is_closing_ || finalized_ || pending_ops_ > 0 || sendfile_req_) {
+        return;
+    }
+    finalized_ = true;
+    if (ring_) {
+        ring_->connections_.erase(this);
+    }
+
+    ReleaseSendResources();
+    close(fd_);
+    fd_ = -1;
+
+    size_t now = uv_now(uv_default_loop());
+    double online_seconds = (now - create_time_) / 1000.0;
+    PLOG_INFO << "TCP Connection " << conn_id_ << " closed, online time: " << online_seconds << " seconds";
+
+    if (server_) {
+        server_->OnClose(std::shared_ptr<TcpConnection>(this, [](TcpConnection*){}));
+    }
+
+    // 心跳定时器关闭后再释放连接对象
+    uv_close((uv_handle_t*)&heartbeat_timer_, [](uv_handle_t* handle) {
+        delete static_cast<IoUringConnection*>(static_cast<TcpConnection*>(handle->data));
+    });
+}
+
+} // namespace uv_net
+
+#else // UV_NET_HAVE_IO_URING
+
+namespace uv_net {
+
+// 非 Linux 平台：io_uring 不可用，TcpServer 会回退到 libuv 传输
+
+IoUringLoop::IoUringLoop(uv_loop_t* loop, TcpServer* server)
+    : loop_(loop), server_(server), ring_fd_(-1), listen_fd_(-1),
+      poll_handle_(nullptr), prepare_handle_(nullptr) {
+}
+
+IoUringLoop::~IoUringLoop() {
+}
+
+bool IoUringLoop::IsSupported() {
+    return false;
+}
+
+bool IoUringLoop::Init(unsigned queue_depth, unsigned buffer_count, unsigned buffer_size) {
+    return false;
+}
+
+bool IoUringLoop::Listen(const std::string& ip, int port) {
+    return false;
+}
+
+} // namespace uv_net
+
+#endif // UV_NET_HAVE_IO_URING
@@ -0,0 +1,235 @@
+#include "uv_net/resp_protocol.h"
+#include "uv_net/simd.h"
+#include <cstdio>
+
+namespace uv_net {
+
+static const int64_t kMaxArgs = 1024 * 1024;
+static const int64_t kMaxBulkLength = 512LL * 1024 * 1024;
+
+// ---------------- RespReply ----------------
+
+void RespReply::AppendNumber(char type, int64_t value) {
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%c%lld\r\n", type, static_cast<long long>(value));
+    buffer_.append(buf, static_cast<size_t>(n));
+}
+
+void RespReply::SimpleString(StringView str) {
+    buffer_.push_back('+');
+    buffer_.append(str.Data(), str.Size());
+    buffer_.append("\r\n", 2);
+}
+
+void RespReply::Error(StringView message) {
+    buffer_.push_back('-');
+    buffer_.append(message.Data(), message.Size());
+    buffer_.append("\r\n", 2);
+}
+
+void RespReply::Integer(int64_t value) {
+    AppendNumber(':', value);
+}
+
+void RespReply::BulkString(StringView str) {
+    AppendNumber('$', static_cast<int64_t>(str.Size()));
+    buffer_.append(str.Data(), str.Size());
+    buffer_.append("\r\n", 2);
+}
+
+void RespReply::Null() {
+    buffer_.append("$-1\r\n", 5);
+}
+
+void RespReply::ArrayHeader(size_t count) {
+    AppendNumber('*', static_cast<int64_t>(count));
+}
+
+// ---------------- RespProtocol ----------------
+
+RespProtocol::RespProtocol(size_t max_command_size)
+    : max_command_size_(max_command_size), pos_(0), command_start_(0), complete_end_(0), pending_args_(-1), pending_bulk_(0), need_hint_(0), command_first_(0) {
+}
+
+size_t RespProtocol::ReadLine(const char* buff, size_t len, size_t pos, size_t& line_end) {
+    const char* end = buff + len;
+    const char* lf = FindByte(buff + pos, end, '\n');
+    if (lf == end) {
+        return 0;
+    }
+    size_t lf_pos = static_cast<size_t>(lf - buff);
+    line_end = (lf_pos > pos && buff[lf_pos - 1] == '\r') ? lf_pos - 1 : lf_pos;
+    return lf_pos + 1;
+}
+
+bool RespProtocol::ParseInteger(const char* begin, const char* end, int64_t& value) {
+    bool negative = false;
+    if (begin < end && *begin == '-') {
+        negative = true;
+        ++begin;
+    }
+    if (begin == end || end - begin > 18) {
+        return false;
+    }
+    int64_t result = 0;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        result = result * 10 + (*p - '0');
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+bool RespProtocol::ParseMore(const char* buff, size_t len) {
+    need_hint_ = 0;
+    for (;;) {
+        size_t line_end = 0;
+        size_t next = 0;
+
+        if (pending_args_ < 0) {
+            // 新命令
+            if (pos_ >= len) {
+                return true;
+            }
+            command_start_ = pos_;
+            next = ReadLine(buff, len, pos_, line_end);
+            if (next == 0) {
+                need_hint_ = 1;
+                return !CommandTooLarge(len);
+            }
+            command_first_ = spans_.size();
+            if (buff[pos_] == '*') {
+                int64_t count = 0;
+                if (!ParseInteger(buff + pos_ + 1, buff + line_end, count) || count > kMaxArgs) {
+                    return false;
+                }
+                pos_ = next;
+                if (count <= 0) {
+                    complete_end_ = pos_; // 空数组，忽略
+                    continue;
+                }
+                pending_args_ = count;
+            } else {
+                // inline 命令：以空格分隔的一行
+                if (CommandTooLarge(next)) {
+                    return false;
+                }
+                size_t p = pos_;
+                while (p < line_end) {
+                    while (p < line_end && buff[p] == ' ') {
+                        ++p;
+                    }
+                    size_t start = p;
+                    while (p < line_end && buff[p] != ' ') {
+                        ++p;
+                    }
+                    if (p > start) {
+                        spans_.push_back(Span{start, p - start});
+                    }
+                }
+                pos_ = next;
+                complete_end_ = pos_;
+                if (spans_.size() > command_first_) {
+                    commands_.emplace_back(command_first_, spans_.size() - command_first_);
+                }
+                continue;
+            }
+        }
+
+        // 命令的元素
+        while (pending_args_ > 0) {
+            if (pending_bulk_ > 0) {
+                if (len - pos_ < pending_bulk_) {
+                    need_hint_ = pending_bulk_ - (len - pos_);
+                    return true;
+                }
+                size_t data_len = pending_bulk_ - 2;
+                if (buff[pos_ + data_len] != '\r' || buff[pos_ + data_len + 1] != '\n') {
+                    return false;
+                }
+                spans_.push_back(Span{pos_, data_len});
+                pos_ += pending_bulk_;
+                pending_bulk_ = 0;
+                pending_args_--;
+                continue;
+            }
+
+            next = ReadLine(buff, len, pos_, line_end);
+            if (next == 0) {
+                need_hint_ = 1;
+                return !CommandTooLarge(len);
+            }
+            if (CommandTooLarge(next)) {
+                return false;
+            }
+            char type = buff[pos_];
+            if (type == '$') {
+                int64_t bulk_len = 0;
+                if (!ParseInteger(buff + pos_ + 1, buff + line_end, bulk_len) || bulk_len > kMaxBulkLength) {
+                    return false;
+                }
+                pos_ = next;
+                if (bulk_len < 0) {
+                    spans_.push_back(Span{pos_, 0}); // null bulk string
+                    pending_args_--;
+                } else {
+                    pending_bulk_ = static_cast<size_t>(bulk_len) + 2;
+                    if (CommandTooLarge(pos_ + pending_bulk_)) {
+                        return false;
+                    }
+                }
+            } else if (type == ':' || type == '+') {
+                spans_.push_back(Span{pos_ + 1, line_end - pos_ - 1});
+                pos_ = next;
+                pending_args_--;
+            } else {
+                return false;
+            }
+        }
+
+        commands_.emplace_back(command_first_, spans_.size() - command_first_);
+        complete_end_ = pos_;
+        pending_args_ = -1;
+    }
+}
+
+PackageStatus RespProtocol::Parse(const char* buff, size_t len, PackageInfo& info) {
+    if (!ParseMore(buff, len)) {
+        return PackageError;
+    }
+    if (commands_.empty() && complete_end_ == 0) {
+        info.need_len = need_hint_;
+        return PackageLess;
+    }
+
+    // 完整命令的参数转换为视图交给回调，未完成命令的偏移改为相对下一个包的起始位置
+    // 只有空数组或空行时批次为空，仍以 PackageFull 返回以便连接释放这部分数据
+    size_t complete_spans = pending_args_ >= 0 ? command_first_ : spans_.size();
+    batch_.args_.resize(complete_spans);
+    for (size_t i = 0; i < complete_spans; ++i) {
+        batch_.args_[i] = StringView(buff + spans_[i].offset, spans_[i].len);
+    }
+    batch_.commands_.swap(commands_);
+    commands_.clear();
+
+    spans_.erase(spans_.begin(), spans_.begin() + complete_spans);
+    for (auto& span : spans_) {
+        span.offset -= complete_end_;
+    }
+    command_first_ = 0;
+    pos_ -= complete_end_;
+    if (pending_args_ >= 0) {
+        command_start_ -= complete_end_;
+    }
+
+    info.package_len = complete_end_;
+    info.payload_offset = 0;
+    info.payload_len = complete_end_;
+    info.batch = true;
+    complete_end_ = 0;
+    return PackageFull;
+}
+
+} // namespace uv_net
@@ -0,0 +1,44 @@
+#include "uv_net/resp_server.h"
+#include "uv_net/tcp_connection.h"
+#include <plog/Log.h>
+
+namespace uv_net {
+
+RespServer::RespServer(uv_loop_t* loop, const ServerConfig& config) : TcpServer(loop, config) {
+    size_t max_command_size = config.GetMaxPackageSize();
+    SetProtocolFactory([max_command_size] {
+        return std::unique_ptr<ConnectionProtocol>(new RespProtocol(max_command_size));
+    });
+    PLOG_INFO << "RESP Server created with buffer pool size: " << config.GetReadBufferSize();
+}
+
+RespServer::~RespServer() {
+    PLOG_INFO << "RESP Server destroying";
+    // 基类的析构函数会处理资源释放
+    PLOG_INFO << "RESP Server destroyed";
+}
+
+void RespServer::OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len) {
+    // 命令已由连接上的 RespProtocol 解析，参数视图指向本次回调的数据
+    TcpConnection* tcp_conn = static_cast<TcpConnection*>(conn.get());
+    const RespBatch& batch = static_cast<RespProtocol*>(tcp_conn->GetProtocol())->GetBatch();
+    if (batch.Size() == 0) {
+        return; // 只有空数组或空行，没有需要回复的命令
+    }
+
+    RespReply reply;
+    if (on_command_batch_) {
+        on_command_batch_(conn, batch, reply);
+    } else {
+        for (size_t i = 0; i < batch.Size(); ++i) {
+            reply.Error("ERR unknown command");
+        }
+    }
+
+    // 整批命令的回复一次写出
+    if (!reply.Buffer().empty()) {
+        conn->Send(std::move(reply.Buffer()));
+    }
+}
+
+} // namespace uv_net
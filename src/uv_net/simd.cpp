@@ -0,0 +1,559 @@
+#include "uv_net/simd.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UV_NET_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace uv_net {
+
+static SimdLevel DetectSimdLevel() {
+#ifdef UV_NET_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::SSE42;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel GetSimdLevel() {
+    static const SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE42: return "sse4.2";
+        case SimdLevel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+static SimdLevel ClampLevel(SimdLevel level) {
+    SimdLevel supported = GetSimdLevel();
+    return static_cast<int>(level) > static_cast<int>(supported) ? supported : level;
+}
+
+// ---------------- FindByte ----------------
+
+static const char* FindByteScalar(const char* begin, const char* end, char c) {
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == c) {
+            return p;
+        }
+    }
+    return end;
+}
+
+#ifdef UV_NET_SIMD_X86
+__attribute__((target("sse2")))
+static const char* FindByteSse2(const char* begin, const char* end, char c) {
+    const char* p = begin;
+    const __m128i needle = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return FindByteScalar(p, end, c);
+}
+
+__attribute__((target("avx2")))
+static const char* FindByteAvx2(const char* begin, const char* end, char c) {
+    const char* p = begin;
+    const __m256i needle = _mm256_set1_epi8(c);
+    // 每次处理64字节，两个比较结果合并为一个64位掩码
+    while (end - p >= 64) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        uint64_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, needle)));
+        uint64_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, needle)));
+        uint64_t mask = lo | (hi << 32);
+        if (mask != 0) {
+            return p + __builtin_ctzll(mask);
+        }
+        p += 64;
+    }
+    if (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return FindByteSse2(p, end, c);
+}
+#endif
+
+const char* FindByte(SimdLevel level, const char* begin, const char* end, char c) {
+#ifdef UV_NET_SIMD_X86
+    switch (ClampLevel(level)) {
+        case SimdLevel::AVX2: return FindByteAvx2(begin, end, c);
+        case SimdLevel::SSE42:
+        case SimdLevel::SSE2: return FindByteSse2(begin, end, c);
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return FindByteScalar(begin, end, c);
+}
+
+const char* FindByte(const char* begin, const char* end, char c) {
+    return FindByte(GetSimdLevel(), begin, end, c);
+}
+
+// ---------------- MaskBytes ----------------
+
+// 从 offset 开始的4字节掩码，按内存顺序拼成32位值（长度为4的倍数的块内位置不变）
+static uint32_t RotatedKey(const uint8_t key[4], size_t offset) {
+    uint8_t rotated[4];
+    for (size_t i = 0; i < 4; ++i) {
+        rotated[i] = key[(offset + i) & 3];
+    }
+    uint32_t key32;
+    memcpy(&key32, rotated, 4);
+    return key32;
+}
+
+// 64位整数逐块处理，不支持 SIMD 时使用，也负责 SIMD 实现的尾部
+static void MaskBytesScalar(char* data, size_t len, const uint8_t key[4], size_t offset) {
+    uint32_t key32 = RotatedKey(key, offset);
+    uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, data + i, 8);
+        chunk ^= key64;
+        memcpy(data + i, &chunk, 8);
+    }
+    for (; i < len; ++i) {
+        data[i] ^= static_cast<char>(key[(offset + i) & 3]);
+    }
+}
+
+#ifdef UV_NET_SIMD_X86
+__attribute__((target("sse2")))
+static void MaskBytesSse2(char* data, size_t len, const uint8_t key[4], size_t offset) {
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(RotatedKey(key, offset)));
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        __m128i a = _mm_loadu_si128(p);
+        __m128i b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2);
+        __m128i d = _mm_loadu_si128(p + 3);
+        _mm_storeu_si128(p, _mm_xor_si128(a, mask));
+        _mm_storeu_si128(p + 1, _mm_xor_si128(b, mask));
+        _mm_storeu_si128(p + 2, _mm_xor_si128(c, mask));
+        _mm_storeu_si128(p + 3, _mm_xor_si128(d, mask));
+    }
+    for (; i + 16 <= len; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), mask));
+    }
+    MaskBytesScalar(data + i, len - i, key, offset + i);
+}
+
+__attribute__((target("avx2")))
+static void MaskBytesAvx2(char* data, size_t len, const uint8_t key[4], size_t offset) {
+    // 短数据用 SSE2 更快（避免 256 位指令的启动开销）
+    if (len < 128) {
+        MaskBytesSse2(data, len, key, offset);
+        return;
+    }
+    // 较长的数据先处理到32字节对齐，主循环的读写不跨缓存行
+    size_t head = 0;
+    if (len >= 256) {
+        head = (32 - (reinterpret_cast<uintptr_t>(data) & 31)) & 31;
+        MaskBytesScalar(data, head, key, offset);
+    }
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(RotatedKey(key, offset + head)));
+    size_t i = head;
+    if (head > 0 || (reinterpret_cast<uintptr_t>(data) & 31) == 0) {
+        for (; i + 128 <= len; i += 128) {
+            __m256i* p = reinterpret_cast<__m256i*>(data + i);
+            __m256i a = _mm256_load_si256(p);
+            __m256i b = _mm256_load_si256(p + 1);
+            __m256i c = _mm256_load_si256(p + 2);
+            __m256i d = _mm256_load_si256(p + 3);
+            _mm256_store_si256(p, _mm256_xor_si256(a, mask));
+            _mm256_store_si256(p + 1, _mm256_xor_si256(b, mask));
+            _mm256_store_si256(p + 2, _mm256_xor_si256(c, mask));
+            _mm256_store_si256(p + 3, _mm256_xor_si256(d, mask));
+        }
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), mask));
+    }
+    MaskBytesScalar(data + i, len - i, key, offset + i);
+}
+#endif
+
+void MaskBytes(SimdLevel level, char* data, size_t len, const uint8_t key[4], size_t offset) {
+#ifdef UV_NET_SIMD_X86
+    switch (ClampLevel(level)) {
+        case SimdLevel::AVX2: MaskBytesAvx2(data, len, key, offset); return;
+        case SimdLevel::SSE42:
+        case SimdLevel::SSE2: MaskBytesSse2(data, len, key, offset); return;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    MaskBytesScalar(data, len, key, offset);
+}
+
+void MaskBytes(char* data, size_t len, const uint8_t key[4], size_t offset) {
+    MaskBytes(GetSimdLevel(), data, len, key, offset);
+}
+
+// ---------------- ValidateUtf8 ----------------
+
+// 由首字节得到字符的字节数，非法首字节（C0、C1、F5～FF）和后续字节按 1 处理
+static size_t Utf8SequenceLength(uint8_t lead) {
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return 2;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        return 4;
+    }
+    return 1;
+}
+
+// s[0, n) 是否为合法字符（n 为完整长度时）或其合法前缀
+static bool IsValidUtf8Prefix(const uint8_t* s, size_t n) {
+    uint8_t lead = s[0];
+    if (lead >= 0x80 && Utf8SequenceLength(lead) == 1) {
+        return false;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        uint8_t lo = 0x80;
+        uint8_t hi = 0xBF;
+        // 第二个字节的范围排除超长编码（E0、F0）、代理项（ED）和超过 U+10FFFF 的码点（F4）
+        if (i == 1) {
+            switch (lead) {
+                case 0xE0: lo = 0xA0; break;
+                case 0xED: hi = 0x9F; break;
+                case 0xF0: lo = 0x90; break;
+                case 0xF4: hi = 0x8F; break;
+                default: break;
+            }
+        }
+        if (s[i] < lo || s[i] > hi) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ValidateUtf8Scalar(const uint8_t* s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        // 8 字节全为 ASCII 时整块跳过
+        if (i + 8 <= len) {
+            uint64_t chunk;
+            memcpy(&chunk, s + i, 8);
+            if ((chunk & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        if (s[i] < 0x80) {
+            ++i;
+            continue;
+        }
+        size_t n = Utf8SequenceLength(s[i]);
+        if (n == 1 || i + n > len || !IsValidUtf8Prefix(s + i, n)) {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+#ifdef UV_NET_SIMD_X86
+// 查表法（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"）：
+// 以前一字节的高、低半字节和当前字节的高半字节查三张 16 项表，三者按位与不为 0 即为错误；
+// 3、4 字节字符的第三、四字节是否为后续字节另行按前 2、3 个字节检查
+static const uint8_t kTooShort = 1 << 0;     // 首字节后跟 ASCII 或首字节
+static const uint8_t kTooLong = 1 << 1;      // ASCII 后跟后续字节
+static const uint8_t kOverlong3 = 1 << 2;    // E0 80..9F
+static const uint8_t kTooLarge = 1 << 3;     // F4 90..BF，F5..FF
+static const uint8_t kSurrogate = 1 << 4;    // ED A0..BF
+static const uint8_t kOverlong2 = 1 << 5;    // C0/C1 后续字节
+static const uint8_t kTooLarge1000 = 1 << 6; // F5..FF 80..8F
+static const uint8_t kOverlong4 = 1 << 6;    // F0 80..8F
+static const uint8_t kTwoConts = 1 << 7;     // 后续字节后跟后续字节（由长度检查抵消合法情况）
+static const uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// 前一字节的高半字节
+static const uint8_t kUtf8Byte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+};
+// 前一字节的低半字节
+static const uint8_t kUtf8Byte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000
+};
+// 当前字节的高半字节
+static const uint8_t kUtf8Byte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort
+};
+
+// SSE4.2 实现每次检查 16 字节，状态为上一块的数据、上一块末尾是否有不完整字符、累积的错误
+struct Utf8StateSse {
+    __m128i prev_input;
+    __m128i prev_incomplete;
+    __m128i error;
+};
+
+__attribute__((target("sse4.2")))
+static inline void Utf8CheckSse(Utf8StateSse& st, __m128i input) {
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(input, st.prev_input, 15);
+    __m128i byte_1_high = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1High)),
+                                           _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+    __m128i byte_1_low = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1Low)),
+                                          _mm_and_si128(prev1, low_nibble));
+    __m128i byte_2_high = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte2High)),
+                                           _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // 前 2 个字节为 E0 以上或前 3 个字节为 F0 以上时，当前字节必须是后续字节
+    __m128i prev2 = _mm_alignr_epi8(input, st.prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, st.prev_input, 13);
+    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+    __m128i must23_80 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+    st.error = _mm_or_si128(st.error, _mm_xor_si128(must23_80, special));
+
+    // 最后 3 个字节中的首字节需要的后续字节在下一块
+    const __m128i max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                            static_cast<char>(0xC0 - 1));
+    st.prev_incomplete = _mm_subs_epu8(input, max_value);
+    st.prev_input = input;
+}
+
+__attribute__((target("sse4.2")))
+static inline void Utf8BlockSse(Utf8StateSse& st, const uint8_t* p) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+    // 64 字节全为 ASCII 时只需确认上一块没有未完成的字符
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) == 0) {
+        st.error = _mm_or_si128(st.error, st.prev_incomplete);
+        st.prev_incomplete = _mm_setzero_si128();
+        st.prev_input = d;
+        return;
+    }
+    Utf8CheckSse(st, a);
+    Utf8CheckSse(st, b);
+    Utf8CheckSse(st, c);
+    Utf8CheckSse(st, d);
+}
+
+__attribute__((target("sse4.2")))
+static bool ValidateUtf8Sse42(const uint8_t* s, size_t len) {
+    Utf8StateSse st;
+    st.prev_input = _mm_setzero_si128();
+    st.prev_incomplete = _mm_setzero_si128();
+    st.error = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        Utf8BlockSse(st, s + i);
+    }
+    // 尾部补 0（ASCII）成一整块，末尾不完整的字符会被判为错误
+    if (i < len) {
+        uint8_t tail[64] = {0};
+        memcpy(tail, s + i, len - i);
+        Utf8BlockSse(st, tail);
+    }
+    st.error = _mm_or_si128(st.error, st.prev_incomplete);
+    return _mm_testz_si128(st.error, st.error) != 0;
+}
+
+struct Utf8StateAvx2 {
+    __m256i prev_input;
+    __m256i prev_incomplete;
+    __m256i error;
+};
+
+// input 之前 n 个字节位置的数据（跨越上一块），n 为 1～3
+template <int N>
+__attribute__((target("avx2")))
+static inline __m256i Utf8PrevAvx2(__m256i input, __m256i prev_input) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i Utf8LookupAvx2(const uint8_t table[16], __m256i index) {
+    return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table))), index);
+}
+
+__attribute__((target("avx2")))
+static inline void Utf8CheckAvx2(Utf8StateAvx2& st, __m256i input) {
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev1 = Utf8PrevAvx2<1>(input, st.prev_input);
+    __m256i byte_1_high = Utf8LookupAvx2(kUtf8Byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+    __m256i byte_1_low = Utf8LookupAvx2(kUtf8Byte1Low, _mm256_and_si256(prev1, low_nibble));
+    __m256i byte_2_high = Utf8LookupAvx2(kUtf8Byte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    __m256i prev2 = Utf8PrevAvx2<2>(input, st.prev_input);
+    __m256i prev3 = Utf8PrevAvx2<3>(input, st.prev_input);
+    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+    __m256i must23_80 = _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+    st.error = _mm256_or_si256(st.error, _mm256_xor_si256(must23_80, special));
+
+    const __m256i max_value = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                               static_cast<char>(0xC0 - 1));
+    st.prev_incomplete = _mm256_subs_epu8(input, max_value);
+    st.prev_input = input;
+}
+
+__attribute__((target("avx2")))
+static inline void Utf8BlockAvx2(Utf8StateAvx2& st, const uint8_t* p) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) == 0) {
+        st.error = _mm256_or_si256(st.error, st.prev_incomplete);
+        st.prev_incomplete = _mm256_setzero_si256();
+        st.prev_input = b;
+        return;
+    }
+    Utf8CheckAvx2(st, a);
+    Utf8CheckAvx2(st, b);
+}
+
+__attribute__((target("avx2")))
+static bool ValidateUtf8Avx2(const uint8_t* s, size_t len) {
+    Utf8StateAvx2 st;
+    st.prev_input = _mm256_setzero_si256();
+    st.prev_incomplete = _mm256_setzero_si256();
+    st.error = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        Utf8BlockAvx2(st, s + i);
+    }
+    if (i < len) {
+        uint8_t tail[64] = {0};
+        memcpy(tail, s + i, len - i);
+        Utf8BlockAvx2(st, tail);
+    }
+    st.error = _mm256_or_si256(st.error, st.prev_incomplete);
+    return _mm256_testz_si256(st.error, st.error) != 0;
+}
+#endif
+
+bool ValidateUtf8(SimdLevel level, const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+#ifdef UV_NET_SIMD_X86
+    // 很短的数据（如聊天消息）逐字节检查更快
+    if (len >= 32) {
+        switch (ClampLevel(level)) {
+            case SimdLevel::AVX2: return ValidateUtf8Avx2(s, len);
+            case SimdLevel::SSE42: return ValidateUtf8Sse42(s, len);
+            default: break;
+        }
+    }
+#else
+    (void)level;
+#endif
+    return ValidateUtf8Scalar(s, len);
+}
+
+bool ValidateUtf8(const char* data, size_t len) {
+    return ValidateUtf8(GetSimdLevel(), data, len);
+}
+
+bool Utf8Validator::Update(const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    // 先补全上一段末尾的不完整字符
+    if (pending_len_ > 0) {
+        size_t need = Utf8SequenceLength(static_cast<uint8_t>(pending_[0]));
+        size_t n = need - pending_len_ < len ? need - pending_len_ : len;
+        memcpy(pending_ + pending_len_, s, n);
+        pending_len_ += n;
+        s += n;
+        len -= n;
+        if (!IsValidUtf8Prefix(reinterpret_cast<const uint8_t*>(pending_), pending_len_)) {
+            return false;
+        }
+        if (pending_len_ < need) {
+            return true;
+        }
+        pending_len_ = 0;
+    }
+
+    // 末尾最多 3 个字节可能是不完整的字符，留到下一段
+    size_t tail = 0;
+    for (size_t k = 1; k <= 3 && k <= len; ++k) {
+        uint8_t c = s[len - k];
+        if ((c & 0xC0) == 0x80) {
+            continue;
+        }
+        if (Utf8SequenceLength(c) > k) {
+            tail = k;
+        }
+        break;
+    }
+    if (!ValidateUtf8(reinterpret_cast<const char*>(s), len - tail)) {
+        return false;
+    }
+    if (tail > 0) {
+        memcpy(pending_, s + len - tail, tail);
+        pending_len_ = tail;
+        return IsValidUtf8Prefix(reinterpret_cast<const uint8_t*>(pending_), pending_len_);
+    }
+    return true;
+}
+
+} // namespace uv_net
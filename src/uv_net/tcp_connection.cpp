@@ -4,12 +4,24 @@
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 #include <plog/Log.h>
 
 namespace uv_net {
 
 TcpConnection::TcpConnection(TcpServer* server) 
-    : server_(server), port_(0), conn_id_(0), is_closing_(false), is_closing_gracefully_(false), is_writing_(false), is_heartbeat_running_(false) {
+    : server_(server), port_(0), conn_id_(0), is_closing_(false), is_closing_gracefully_(false), is_writing_(false), is_heartbeat_running_(false),
+      recv_offset_(0), recv_need_(0),
+      sendfile_req_(nullptr), close_after_sendfile_(false), writable_poll_(nullptr), poll_fd_(-1),
+      zerocopy_threshold_(server ? server->GetConfig().GetZeroCopyThreshold() : 0),
+      zerocopy_state_(0), zerocopy_next_seq_(0), zerocopy_sending_(nullptr), zerocopy_check_(nullptr),
+      cork_depth_(0), flush_scheduled_(false) {
     handle_.data = this;
     // 初始化心跳定时器
     uv_timer_init(uv_default_loop(), &heartbeat_timer_);
@@ -25,6 +37,76 @@ TcpConnection::~TcpConnection() {
 }
 
 void TcpConnection::Send(const char* data, size_t len) {
+    EnqueueSend(SendItem(data, len));
+}
+
+void TcpConnection::Send(std::string&& data) {
+    EnqueueSend(SendItem(std::move(data)));
+}
+
+void TcpConnection::Send(Buffer&& buffer) {
+    EnqueueSend(SendItem(std::move(buffer)));
+}
+
+SendBuffer TcpConnection::NewSendBuffer(size_t capacity) {
+    size_t headroom = 0;
+    if (ConnectionProtocol* protocol = EnsureProtocol()) {
+        headroom = protocol->MaxHeaderSize();
+    } else if (auto server_protocol = server_->GetServerProtocol()) {
+        headroom = server_protocol->MaxHeaderSize();
+    }
+    return SendBuffer(headroom, capacity);
+}
+
+void TcpConnection::SendPackage(SendBuffer&& buffer) {
+    bool encoded = true;
+    if (ConnectionProtocol* protocol = EnsureProtocol()) {
+        encoded = protocol->Encode(buffer);
+    } else if (auto server_protocol = server_->GetServerProtocol()) {
+        encoded = server_protocol->Encode(buffer);
+    }
+    if (!encoded) {
+        PLOG_ERROR << "TCP Connection " << conn_id_ << " encode failed: " << buffer.Size() << " bytes";
+        return;
+    }
+    // Send(Buffer&&) 为虚函数，派生连接（如 WebSocket）会再加上自己的帧
+    Send(buffer.Release());
+}
+
+void TcpConnection::Send(const struct iovec* iov, size_t iovcnt) {
+    // 队列空闲时直接从调用方内存 writev，避免拼接
+    size_t skip = 0;
+    if (!is_closing_ && !is_closing_gracefully_ && !is_writing_ && send_queue_.empty() &&
+        cork_depth_ == 0 && !server_->GetConfig().GetAutoFlush() && zerocopy_threshold_ == 0 && iovcnt > 0) {
+        std::vector<uv_buf_t> bufs(iovcnt);
+        for (size_t i = 0; i < iovcnt; ++i) {
+            bufs[i] = uv_buf_init(static_cast<char*>(iov[i].iov_base), iov[i].iov_len);
+        }
+        int r = uv_try_write((uv_stream_t*)&handle_, bufs.data(), static_cast<unsigned int>(iovcnt));
+        if (r > 0) {
+            skip = static_cast<size_t>(r);
+            last_active_time_ = uv_now(uv_default_loop());
+        }
+    }
+
+    // 未写完的部分拷贝一次进入发送队列
+    std::string rest;
+    for (size_t i = 0; i < iovcnt; ++i) {
+        const char* base = static_cast<const char*>(iov[i].iov_base);
+        size_t len = iov[i].iov_len;
+        if (skip >= len) {
+            skip -= len;
+            continue;
+        }
+        rest.append(base + skip, len - skip);
+        skip = 0;
+    }
+    if (!rest.empty()) {
+        EnqueueSend(SendItem(std::move(rest)));
+    }
+}
+
+void TcpConnection::EnqueueSend(SendItem&& item) {
     // 如果正在关闭，直接丢弃
     if (is_closing_ || is_closing_gracefully_) {
         PLOG_INFO << "TCP Connection " << conn_id_ << " is closing, dropping send request";
@@ -36,42 +118,119 @@ void TcpConnection::Send(const char* data, size_t len) {
         PLOG_WARNING << "TCP Connection " << conn_id_ << " send queue full, dropping send request";
         return;
     }
-    send_queue_.emplace(data, len);
+    size_t len = item.Size();
+    send_queue_.push(std::move(item));
     
     PLOG_INFO << "TCP Connection " << conn_id_ << " send queued " << len << " bytes";
     
     // 更新最后活跃时间
     last_active_time_ = uv_now(uv_default_loop());
+
+    // 发送合并：正在写时由写完成回调继续发送，否则登记到本轮循环末尾
+    if (server_->GetConfig().GetAutoFlush() && !is_writing_) {
+        if (!flush_scheduled_) {
+            flush_scheduled_ = true;
+            server_->ScheduleFlush(this);
+        }
+        return;
+    }
     
     // 触发发送尝试
     TrySend();
 }
 
+void TcpConnection::Cork() {
+    cork_depth_++;
+}
+
+void TcpConnection::Uncork() {
+    if (cork_depth_ > 0 && --cork_depth_ == 0) {
+        TrySend();
+    }
+}
+
+void TcpConnection::FlushSend() {
+    flush_scheduled_ = false;
+    TrySend();
+}
+
+void TcpConnection::SendFile(int fd, int64_t offset, size_t length, CallbackSendFile cb) {
+    // 如果正在关闭，直接丢弃
+    if (is_closing_ || is_closing_gracefully_) {
+        PLOG_INFO << "TCP Connection " << conn_id_ << " is closing, dropping sendfile request";
+        if (cb) {
+            cb(std::shared_ptr<TcpConnection>(this, [](TcpConnection*){}), UV_ECANCELED);
+        }
+        return;
+    }
+
+    // 文件区间与普通数据共用发送队列，保证顺序与背压
+    if (send_queue_.size() >= server_->GetMaxSendQueueSize()) {
+        PLOG_WARNING << "TCP Connection " << conn_id_ << " send queue full, dropping sendfile request";
+        if (cb) {
+            cb(std::shared_ptr<TcpConnection>(this, [](TcpConnection*){}), UV_ENOBUFS);
+        }
+        return;
+    }
+    send_queue_.emplace(fd, offset, length, std::move(cb));
+
+    PLOG_INFO << "TCP Connection " << conn_id_ << " sendfile queued " << length << " bytes at offset " << offset;
+
+    // 更新最后活跃时间
+    last_active_time_ = uv_now(uv_default_loop());
+
+    // 触发发送尝试
+    TrySend();
+}
+
 void TcpConnection::TrySend() {
-    std::string data_to_send;
-    // 如果正在发送，或者队列为空，直接返回
-    if (is_writing_ || send_queue_.empty()) {
+    // 如果正在发送、队列为空或处于 Cork 状态，直接返回
+    if (is_writing_ || send_queue_.empty() || cork_depth_ > 0) {
+        return;
+    }
+
+    // 文件区间走 sendfile 路径
+    if (send_queue_.front().IsFile()) {
+        SendItem item = std::move(send_queue_.front());
+        send_queue_.pop();
+        is_writing_ = true;
+        StartSendFile(std::move(item));
         return;
     }
-    
-    // 取出队首数据
-    data_to_send = std::move(send_queue_.front());
-    send_queue_.pop();
     
     // 标记正在发送
     is_writing_ = true;
 
-    PLOG_INFO << "TCP Connection " << conn_id_ << " sending " << data_to_send.size() << " bytes";
+    // 大块数据走 MSG_ZEROCOPY，缓冲区在完成通知到达前不释放
+    if (UseZeroCopy(send_queue_.front().Size())) {
+        SendItem item = std::move(send_queue_.front());
+        send_queue_.pop();
+        StartZeroCopy(std::move(item));
+        return;
+    }
 
-    // 准备 libuv 写请求
+    // 合并队首连续的内存数据，一次 writev 发出
     WriteReq* req = new WriteReq();
-    // 将数据移动到 req 中，保证异步回调期间数据有效
-    req->data = std::move(data_to_send);
     req->req.data = this;
+    size_t total = 0;
+    while (!send_queue_.empty() && req->items.size() < kMaxWriteBufs) {
+        SendItem& item = send_queue_.front();
+        if (item.IsFile() || (!req->items.empty() && UseZeroCopy(item.Size()))) {
+            break;
+        }
+        total += item.Size();
+        req->items.push_back(std::move(item));
+        send_queue_.pop();
+    }
 
-    uv_buf_t buf = uv_buf_init(const_cast<char*>(req->data.c_str()), req->data.size());
+    PLOG_INFO << "TCP Connection " << conn_id_ << " sending " << total << " bytes in " << req->items.size() << " buffers";
 
-    int r = uv_write(&req->req, (uv_stream_t*)&handle_, &buf, 1, 
+    uv_buf_t bufs[kMaxWriteBufs];
+    for (size_t i = 0; i < req->items.size(); ++i) {
+        bufs[i] = uv_buf_init(const_cast<char*>(req->items[i].Data()), req->items[i].Size());
+    }
+
+    int r = uv_write(&req->req, (uv_stream_t*)&handle_, bufs, static_cast<unsigned int>(req->items.size()), 
         [](uv_write_t* uv_req, int status) {
             // 使用 reinterpret_cast 而不是 static_cast
             WriteReq* wr = reinterpret_cast<WriteReq*>(uv_req);
@@ -90,7 +249,7 @@ void TcpConnection::TrySend() {
         delete req; // 回调没触发，手动删
         is_writing_ = false; // 恢复状态
         // 错误发生，关闭连接
-        Close();
+        CloseImmediately();
     }
 }
 
@@ -98,7 +257,7 @@ void TcpConnection::OnWriteComplete(int status) {
     if (status < 0) {
         if (status != UV_ECANCELED) { // 主动关闭也会产生 ECANCELED，不算错误
             PLOG_ERROR << "TCP Connection " << conn_id_ << " write failed: " << uv_strerror(status);
-            Close();
+            CloseImmediately();
         }
         return;
     }
@@ -114,9 +273,11 @@ void TcpConnection::OnWriteComplete(int status) {
     // *** 关键：尝试发送队列中的下一包数据 ***
     TrySend();
     
-    // 检查是否需要优雅关闭
-    if (is_closing_gracefully_ && send_queue_.empty() && !is_writing_) {
+    // 检查是否需要优雅关闭（零拷贝缓冲区需等待内核完成通知）
+    if (is_closing_gracefully_ && IsSendIdle()) {
         PLOG_INFO << "TCP Connection " << conn_id_ << " send queue empty, closing gracefully";
+        is_closing_ = true;
+        ReleaseSendResources();
         // 发送队列已空，执行实际关闭
         uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
             TcpConnection* conn = static_cast<TcpConnection*>(handle->data);
@@ -128,7 +289,7 @@ void TcpConnection::OnWriteComplete(int status) {
             if (conn->server_) {
                 conn->server_->OnClose(std::shared_ptr<TcpConnection>(conn, [](TcpConnection*){}));
             }
-            delete conn; // 最终释放 Connection 对象
+            conn->DestroyLater(); // 心跳定时器关闭后释放 Connection 对象
         });
     }
 }
@@ -142,32 +303,61 @@ void TcpConnection::Close() {
     StopHeartbeat();
     
     // 检查发送队列是否为空
-    bool is_empty = send_queue_.empty();
-    
-    if (is_empty && !is_writing_) {
+    if (IsSendIdle()) {
         // 发送队列为空，直接关闭
-        is_closing_ = true;
-        PLOG_INFO << "TCP Connection " << conn_id_ << " closing immediately";
-        
-        // 关闭 handle，触发 close 回调
-        uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
-                TcpConnection* conn = static_cast<TcpConnection*>(handle->data);
-                // 计算在线时长（秒）
-                size_t now = uv_now(uv_default_loop());
-                double online_seconds = (now - conn->create_time_) / 1000.0;
-                PLOG_INFO << "TCP Connection " << conn->conn_id_ << " closed immediately, online time: " << online_seconds << " seconds";
-                // 触发用户层的 OnClose
-                if (conn->server_) {
-                    conn->server_->OnClose(std::shared_ptr<TcpConnection>(conn, [](TcpConnection*){}));
-                }
-                delete conn; // 最终释放 Connection 对象
-            });
+        CloseImmediately();
     } else {
         // 发送队列不为空，执行优雅关闭
         is_closing_gracefully_ = true;
         PLOG_INFO << "TCP Connection " << conn_id_ << " closing gracefully";
-        // 不立即关闭，等待发送队列处理完毕
+        // 不立即关闭，等待发送队列处理完毕；Cork 或合并中的数据立即发出
+        cork_depth_ = 0;
+        TrySend();
+    }
+}
+
+void TcpConnection::CloseImmediately() {
+    if (is_closing_) {
+        return;
+    }
+    StopHeartbeat();
+    if (sendfile_req_) {
+        if (sendfile_req_->running) {
+            // 线程池中的 sendfile 仍在写 poll_fd_，完成回调中取消后再关闭
+            close_after_sendfile_ = true;
+        } else {
+            // 等待可写的 sendfile 直接取消，AbortSend 会再次进入这里完成关闭
+            FinishSendFile(UV_ECANCELED);
+        }
+        return;
     }
+    is_closing_ = true;
+    PLOG_INFO << "TCP Connection " << conn_id_ << " closing immediately";
+    CloseHandle();
+}
+
+void TcpConnection::CloseHandle() {
+    ReleaseSendResources();
+
+    // 关闭 handle，触发 close 回调
+    uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
+            TcpConnection* conn = static_cast<TcpConnection*>(handle->data);
+            // 计算在线时长（秒）
+            size_t now = uv_now(uv_default_loop());
+            double online_seconds = (now - conn->create_time_) / 1000.0;
+            PLOG_INFO << "TCP Connection " << conn->conn_id_ << " closed immediately, online time: " << online_seconds << " seconds";
+            // 触发用户层的 OnClose
+            if (conn->server_) {
+                conn->server_->OnClose(std::shared_ptr<TcpConnection>(conn, [](TcpConnection*){}));
+            }
+            conn->DestroyLater(); // 心跳定时器关闭后释放 Connection 对象
+        });
+}
+
+void TcpConnection::DestroyLater() {
+    uv_close((uv_handle_t*)&heartbeat_timer_, [](uv_handle_t* handle) {
+        delete static_cast<TcpConnection*>(handle->data);
+    });
 }
 
 void TcpConnection::StartHeartbeat() {
@@ -209,6 +399,393 @@ void TcpConnection::OnHeartbeatTimeout() {
     // 否则，继续等待下一次心跳检查
 }
 
+int TcpConnection::GetSocketFd() {
+    uv_os_fd_t fd;
+    if (uv_fileno((uv_handle_t*)&handle_, &fd) != 0) {
+        return -1;
+    }
+    return fd;
+}
+
+uv_loop_t* TcpConnection::GetLoop() {
+    return handle_.loop;
+}
+
+void TcpConnection::StartSendFile(SendItem&& item) {
+    SendFileReq* req = new SendFileReq();
+    req->work.data = req;
+    req->conn = this;
+    req->sock_fd = -1;
+    req->file_fd = item.file_fd;
+    req->offset = item.file_offset;
+    req->remaining = item.file_length;
+    req->status = 0;
+    req->would_block = false;
+    req->running = false;
+    req->cb = std::move(item.file_cb);
+    sendfile_req_ = req;
+
+    // sendfile 与可写监听都使用 dup 出的 fd，libuv 的 stream 句柄不感知这条发送路径
+    if (!EnsurePollFd()) {
+        PLOG_ERROR << "TCP Connection " << conn_id_ << " sendfile failed: cannot dup socket fd";
+        FinishSendFile(UV_EBADF);
+        return;
+    }
+    req->sock_fd = poll_fd_;
+
+    PLOG_INFO << "TCP Connection " << conn_id_ << " sendfile " << req->remaining << " bytes at offset " << req->offset;
+    ContinueSendFile();
+}
+
+void TcpConnection::ContinueSendFile() {
+    SendFileReq* req = sendfile_req_;
+    if (req->remaining == 0) {
+        FinishSendFile(0);
+        return;
+    }
+
+    // 在线程池中执行 sendfile，避免读盘阻塞 loop；socket 为非阻塞，发送缓冲区满时返回
+    req->running = true;
+    int r = uv_queue_work(GetLoop(), &req->work,
+        [](uv_work_t* work) {
+            SendFileReq* req = static_cast<SendFileReq*>(work->data);
+            req->would_block = false;
+            while (req->remaining > 0) {
+                off_t offset = static_cast<off_t>(req->offset);
+                ssize_t n = sendfile(req->sock_fd, req->file_fd, &offset, req->remaining);
+                if (n > 0) {
+                    req->offset = offset;
+                    req->remaining -= static_cast<size_t>(n);
+                } else if (n == 0) {
+                    req->status = UV_EOF; // 文件长度不足
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    req->would_block = true;
+                    break;
+                } else {
+                    req->status = uv_translate_sys_error(errno);
+                    break;
+                }
+            }
+        },
+        [](uv_work_t* work, int status) {
+            SendFileReq* req = static_cast<SendFileReq*>(work->data);
+            TcpConnection* conn = req->conn;
+            req->running = false;
+            if (status < 0) {
+                conn->FinishSendFile(status);
+            } else if (conn->is_closing_ || conn->close_after_sendfile_) {
+                // 执行期间连接已开始关闭（对端断开），不再继续发送，AbortSend 完成关闭
+                conn->FinishSendFile(UV_ECANCELED);
+            } else if (req->status < 0 || req->remaining == 0) {
+                conn->FinishSendFile(req->status);
+            } else if (!conn->WaitWritable()) {
+                // 发送缓冲区已满时等待 socket 可写后继续，背压由内核发送缓冲区决定
+                conn->FinishSendFile(UV_EBADF);
+            }
+        });
+
+    if (r != 0) {
+        req->running = false;
+        FinishSendFile(r);
+    }
+}
+
+void TcpConnection::FinishSendFile(int status) {
+    SendFileReq* req = sendfile_req_;
+    sendfile_req_ = nullptr;
+    CallbackSendFile cb = std::move(req->cb);
+    delete req;
+
+    if (status == UV_ECANCELED) {
+        PLOG_INFO << "TCP Connection " << conn_id_ << " sendfile canceled";
+    } else if (status < 0) {
+        PLOG_ERROR << "TCP Connection " << conn_id_ << " sendfile failed: " << uv_strerror(status);
+    } else {
+        PLOG_INFO << "TCP Connection " << conn_id_ << " sendfile complete";
+    }
+
+    if (cb) {
+        cb(std::shared_ptr<TcpConnection>(this, [](TcpConnection*){}), status);
+    }
+
+    if (status < 0) {
+        AbortSend(status);
+        return;
+    }
+
+    OnWriteComplete(0);
+}
+
+bool TcpConnection::UseZeroCopy(size_t len) {
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    if (zerocopy_threshold_ == 0 || len < zerocopy_threshold_ || zerocopy_state_ < 0) {
+        return false;
+    }
+    if (zerocopy_state_ == 0) {
+        int one = 1;
+        if (!EnsurePollFd() || setsockopt(poll_fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0) {
+            PLOG_WARNING << "TCP Connection " << conn_id_ << " SO_ZEROCOPY unsupported, using copy send";
+            zerocopy_state_ = -1;
+            return false;
+        }
+        zerocopy_state_ = 1;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TcpConnection::StartZeroCopy(SendItem&& item) {
+    zerocopy_pending_.emplace_back();
+    ZeroCopyBuffer& buf = zerocopy_pending_.back();
+    buf.item = std::move(item);
+    buf.sent = 0;
+    buf.first_seq = zerocopy_next_seq_;
+    buf.last_seq = zerocopy_next_seq_;
+    buf.outstanding = 0;
+    zerocopy_sending_ = &buf;
+
+    PLOG_INFO << "TCP Connection " << conn_id_ << " zerocopy sending " << buf.item.Size() << " bytes";
+
+    // 每轮循环读取错误队列中的完成通知，EPOLLERR 会唤醒 loop
+    if (!zerocopy_check_) {
+        zerocopy_check_ = new uv_check_t();
+        uv_check_init(GetLoop(), zerocopy_check_);
+        zerocopy_check_->data = this;
+    }
+    uv_check_start(zerocopy_check_, [](uv_check_t* handle) {
+        static_cast<TcpConnection*>(handle->data)->DrainZeroCopyCompletions();
+    });
+
+    ContinueZeroCopy();
+}
+
+void TcpConnection::ContinueZeroCopy() {
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    ZeroCopyBuffer* buf = zerocopy_sending_;
+    while (buf->sent < buf->item.Size()) {
+        const char* ptr = buf->item.Data() + buf->sent;
+        size_t remaining = buf->item.Size() - buf->sent;
+        ssize_t n = send(poll_fd_, ptr, remaining, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            // 每次成功的 MSG_ZEROCOPY 调用占用一个完成序号
+            if (buf->outstanding == 0 && buf->sent == 0) {
+                buf->first_seq = zerocopy_next_seq_;
+            }
+            buf->last_seq = zerocopy_next_seq_++;
+            buf->outstanding++;
+            buf->sent += static_cast<size_t>(n);
+            zerocopy_stats_.sends++;
+            zerocopy_stats_.bytes += static_cast<uint64_t>(n);
+            server_->zerocopy_stats_.sends++;
+            server_->zerocopy_stats_.bytes += static_cast<uint64_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!WaitWritable()) {
+                AbortSend(UV_EBADF);
+            }
+            return;
+        }
+        if (n < 0 && errno == ENOBUFS) {
+            // 未完成的零拷贝通知超过 optmem 限制，本段回退为拷贝发送
+            n = send(poll_fd_, ptr, remaining, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n > 0) {
+                buf->sent += static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!WaitWritable()) {
+                    AbortSend(UV_EBADF);
+                }
+                return;
+            }
+        }
+        int status = uv_translate_sys_error(errno);
+        PLOG_ERROR << "TCP Connection " << conn_id_ << " zerocopy send failed: " << uv_strerror(status);
+        zerocopy_sending_ = nullptr;
+        AbortSend(status);
+        return;
+    }
+
+    // 数据已全部提交，缓冲区留在 zerocopy_pending_ 中直到完成通知到达
+    zerocopy_sending_ = nullptr;
+    DrainZeroCopyCompletions();
+    OnWriteComplete(0);
+#endif
+}
+
+void TcpConnection::DrainZeroCopyCompletions() {
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    for (;;) {
+        char control[128];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(poll_fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            bool is_recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                              (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!is_recverr) {
+                continue;
+            }
+            const struct sock_extended_err* serr = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cm));
+            if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            // 完成通知覆盖闭区间 [lo, hi] 的序号
+            uint32_t lo = serr->ee_info;
+            uint32_t hi = serr->ee_data;
+            uint64_t count = static_cast<uint64_t>(hi - lo) + 1;
+            zerocopy_stats_.completions += count;
+            server_->zerocopy_stats_.completions += count;
+            if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                zerocopy_stats_.copied += count;
+                server_->zerocopy_stats_.copied += count;
+            }
+
+            for (auto& buf : zerocopy_pending_) {
+                if (buf.outstanding == 0) {
+                    continue;
+                }
+                uint32_t from = buf.first_seq > lo ? buf.first_seq : lo;
+                uint32_t to = buf.last_seq < hi ? buf.last_seq : hi;
+                if (from <= to) {
+                    buf.outstanding -= (to - from + 1);
+                }
+            }
+        }
+    }
+
+    // 释放已全部完成的缓冲区
+    for (auto it = zerocopy_pending_.begin(); it != zerocopy_pending_.end();) {
+        if (&*it != zerocopy_sending_ && it->outstanding == 0) {
+            it = zerocopy_pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (zerocopy_pending_.empty() && zerocopy_check_) {
+        uv_check_stop(zerocopy_check_);
+        // 优雅关闭需要等待零拷贝缓冲区全部释放
+        if (is_closing_gracefully_ && send_queue_.empty() && !is_writing_) {
+            OnWriteComplete(0);
+        }
+    }
+#endif
+}
+
+void TcpConnection::AbortSend(int status) {
+    // 文件或零拷贝数据可能已部分写入，字节流无法恢复，丢弃剩余数据并关闭连接
+    std::shared_ptr<TcpConnection> self(this, [](TcpConnection*){});
+    while (!send_queue_.empty()) {
+        SendItem& item = send_queue_.front();
+        if (item.IsFile() && item.file_cb) {
+            item.file_cb(self, UV_ECANCELED);
+        }
+        send_queue_.pop();
+    }
+    // 连接即将关闭，不再等待完成通知（内核自行持有页面引用）
+    for (auto& buf : zerocopy_pending_) {
+        buf.outstanding = 0;
+    }
+    is_writing_ = false;
+    zerocopy_sending_ = nullptr;
+    DrainZeroCopyCompletions();
+    // Close() 在优雅关闭进行中时直接返回，这里必须走立即关闭，否则句柄永远不会关闭
+    CloseImmediately();
+}
+
+bool TcpConnection::EnsurePollFd() {
+    if (poll_fd_ >= 0) {
+        return true;
+    }
+    int fd = GetSocketFd();
+    poll_fd_ = fd >= 0 ? dup(fd) : -1;
+    return poll_fd_ >= 0;
+}
+
+bool TcpConnection::WaitWritable() {
+    if (!writable_poll_) {
+        writable_poll_ = new uv_poll_t();
+        if (uv_poll_init(GetLoop(), writable_poll_, poll_fd_) != 0) {
+            delete writable_poll_;
+            writable_poll_ = nullptr;
+            return false;
+        }
+        writable_poll_->data = this;
+    }
+    return uv_poll_start(writable_poll_, UV_WRITABLE, [](uv_poll_t* handle, int status, int events) {
+        uv_poll_stop(handle);
+        static_cast<TcpConnection*>(handle->data)->OnWritable(status);
+    }) == 0;
+}
+
+void TcpConnection::OnWritable(int status) {
+    // 错误队列中的零拷贝通知同样表现为 POLLERR，libuv 以 UV_EBADF 上报
+    if (status == UV_EBADF) {
+        DrainZeroCopyCompletions();
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(poll_fd_, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) {
+            status = 0;
+        } else if (err != 0) {
+            status = uv_translate_sys_error(err);
+        }
+    }
+
+    if (sendfile_req_) {
+        if (status < 0) {
+            FinishSendFile(status);
+        } else {
+            ContinueSendFile();
+        }
+    } else if (zerocopy_sending_) {
+        if (status < 0) {
+            zerocopy_sending_ = nullptr;
+            AbortSend(status);
+        } else {
+            ContinueZeroCopy();
+        }
+    }
+}
+
+void TcpConnection::ReleaseSendResources() {
+    if (flush_scheduled_ && server_) {
+        server_->CancelFlush(this);
+        flush_scheduled_ = false;
+    }
+    if (writable_poll_) {
+        uv_close((uv_handle_t*)writable_poll_, [](uv_handle_t* handle) {
+            delete (uv_poll_t*)handle;
+        });
+        writable_poll_ = nullptr;
+    }
+    if (zerocopy_check_) {
+        uv_close((uv_handle_t*)zerocopy_check_, [](uv_handle_t* handle) {
+            delete (uv_check_t*)handle;
+        });
+        zerocopy_check_ = nullptr;
+    }
+    if (poll_fd_ >= 0) {
+        close(poll_fd_);
+        poll_fd_ = -1;
+    }
+}
+
 std::string TcpConnection::GetIP() { return ip_; }
 int TcpConnection::GetPort() { return port_; }
 uint32_t TcpConnection::GetConnId() { return conn_id_; }
@@ -219,6 +796,12 @@ void TcpConnection::OnDataReceived(const char* data, size_t len) {
     
     // 将新数据添加到接收缓冲区
     recv_buffer_.insert(recv_buffer_.end(), data, data + len);
+
+    // 逐连接协议解析器优先
+    if (protocol_ || server_->GetProtocolFactory()) {
+        ParseWithProtocol();
+        return;
+    }
     
     // 获取协议解析器
     auto protocol = server_->GetServerProtocol();
@@ -256,4 +839,62 @@ void TcpConnection::OnDataReceived(const char* data, size_t len) {
     }
 }
 
-} // namespace uv_net
\ No newline at end of file
+ConnectionProtocol* TcpConnection::EnsureProtocol() {
+    if (!protocol_ && server_->GetProtocolFactory()) {
+        protocol_ = server_->GetProtocolFactory()();
+    }
+    return protocol_.get();
+}
+
+void TcpConnection::ParseWithProtocol() {
+    EnsureProtocol();
+
+    // 数据不足上次给出的长度，跳过解析
+    if (recv_buffer_.size() - recv_offset_ < recv_need_) {
+        return;
+    }
+    recv_need_ = 0;
+
+    size_t max_package_size = server_->GetConfig().GetMaxPackageSize();
+    while (recv_offset_ < recv_buffer_.size() && !is_closing_ && !is_closing_gracefully_) {
+        const char* ptr = recv_buffer_.data() + recv_offset_;
+        size_t avail = recv_buffer_.size() - recv_offset_;
+        PackageInfo info;
+        PackageStatus status = protocol_->Parse(ptr, avail, info);
+
+        if (status == PackageFull) {
+            if (!info.batch && info.package_len > max_package_size) {
+                PLOG_ERROR << "TCP Connection " << conn_id_ << " package size " << info.package_len << " exceeds limit, closing connection";
+                Close();
+                break;
+            }
+            recv_offset_ += info.package_len;
+            server_->OnMessage(std::shared_ptr<TcpConnection>(this, [](TcpConnection*){}), ptr + info.payload_offset, info.payload_len);
+        } else if (status == PackageLess) {
+            recv_need_ = info.need_len > 0 ? avail + info.need_len : 0;
+            if (recv_need_ > max_package_size) {
+                PLOG_ERROR << "TCP Connection " << conn_id_ << " package size " << recv_need_ << " exceeds limit, closing connection";
+                Close();
+            } else if (recv_need_ > 0) {
+                // 按包长一次性预留空间，后续分段到达时不再扩容
+                recv_buffer_.reserve(recv_offset_ + recv_need_);
+            }
+            break;
+        } else {
+            PLOG_ERROR << "TCP Connection " << conn_id_ << " package parse error, closing connection";
+            Close();
+            break;
+        }
+    }
+
+    // 全部处理完时清空，否则在已处理部分过半时整体前移
+    if (recv_offset_ >= recv_buffer_.size()) {
+        recv_buffer_.clear();
+        recv_offset_ = 0;
+    } else if (recv_offset_ > recv_buffer_.size() / 2) {
+        recv_buffer_.erase(recv_buffer_.begin(), recv_buffer_.begin() + recv_offset_);
+        recv_offset_ = 0;
+    }
+}
+
+} // namespace uv_net
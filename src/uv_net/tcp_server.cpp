@@ -1,5 +1,6 @@
 #include "uv_net/tcp_server.h"
 #include "uv_net/tcp_connection.h"
+#include "uv_net/io_uring_transport.h"
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
@@ -7,6 +8,7 @@
 #include <arpa/inet.h>
 #include <plog/Log.h>
 #include <atomic>
+#include <algorithm>
 
 namespace uv_net {
 
@@ -27,6 +29,11 @@ TcpServer::TcpServer(uv_loop_t* loop, const ServerConfig& config) : loop_(loop),
 TcpServer::~TcpServer() {
     PLOG_INFO << "TCP Server destroying";
     for (auto l : listeners_) { uv_close((uv_handle_t*)l, nullptr); delete l; }
+    for (auto r : io_uring_loops_) { delete r; }
+    if (flush_check_) {
+        uv_close((uv_handle_t*)flush_check_, [](uv_handle_t* h) { delete (uv_check_t*)h; });
+        uv_close((uv_handle_t*)flush_idle_, [](uv_handle_t* h) { delete (uv_idle_t*)h; });
+    }
     for (auto l : loops_) { if (l != loop_) uv_loop_close(l); delete l; }
     PLOG_INFO << "TCP Server destroyed";
 }
@@ -55,14 +62,71 @@ void TcpServer::OnClose(std::shared_ptr<Connection> conn) {
     }
 }
 
+void TcpServer::ScheduleFlush(TcpConnection* conn) {
+    if (!flush_check_) {
+        flush_check_ = new uv_check_t();
+        uv_check_init(loop_, flush_check_);
+        flush_check_->data = this;
+        flush_idle_ = new uv_idle_t();
+        uv_idle_init(loop_, flush_idle_);
+    }
+
+    if (flush_list_.empty()) {
+        uv_check_start(flush_check_, [](uv_check_t* handle) {
+            TcpServer* server = static_cast<TcpServer*>(handle->data);
+            // FlushSend 期间可能有新的登记，交换后再处理
+            std::vector<TcpConnection*> list;
+            list.swap(server->flush_list_);
+            for (TcpConnection* conn : list) {
+                conn->FlushSend();
+            }
+            if (server->flush_list_.empty()) {
+                uv_check_stop(server->flush_check_);
+                uv_idle_stop(server->flush_idle_);
+            }
+        });
+        // 活跃的 idle 句柄使 poll 超时为 0，定时器等回调中的发送不会等到下一次 IO
+        uv_idle_start(flush_idle_, [](uv_idle_t*) {});
+    }
+    flush_list_.push_back(conn);
+}
+
+void TcpServer::CancelFlush(TcpConnection* conn) {
+    auto it = std::find(flush_list_.begin(), flush_list_.end(), conn);
+    if (it != flush_list_.end()) {
+        flush_list_.erase(it);
+    }
+}
+
 // CreateConnection的默认实现，创建TcpConnection对象
 TcpConnection* TcpServer::CreateConnection(TcpServer* server) {
     return new TcpConnection(server);
 }
 
+bool TcpServer::StartIoUring(const std::string& ip, int port) {
+    IoUringLoop* ring = new IoUringLoop(loop_, this);
+    unsigned buffer_count = static_cast<unsigned>(config_.GetIoUringBufferCount());
+    unsigned buffer_size = static_cast<unsigned>(config_.GetReadBufferSize());
+    if (!ring->Init(buffer_count, buffer_count, buffer_size) || !ring->Listen(ip, port)) {
+        delete ring;
+        return false;
+    }
+    io_uring_loops_.push_back(ring);
+    PLOG_INFO << "TCP Server started on " << ip << ":" << port << " (io_uring)";
+    return true;
+}
+
 bool TcpServer::Start(const std::string& ip, int port) {
     PLOG_INFO << "TCP Server starting on " << ip << ":" << port;
     
+    // io_uring传输：运行时探测，不可用时回退到libuv
+    if (config_.GetUseIoUring() && CanUseIoUring()) {
+        if (IoUringLoop::IsSupported() && StartIoUring(ip, port)) {
+            return true;
+        }
+        PLOG_WARNING << "TCP Server io_uring unavailable, falling back to libuv";
+    }
+    
     // 单线程模式：直接使用传入的loop，不创建额外线程
     uv_tcp_t* listener = new uv_tcp_t();
     uv_tcp_init(loop_, listener);
@@ -142,13 +206,15 @@ bool TcpServer::Start(const std::string& ip, int port) {
                     if (nread > 0) {
                         PLOG_INFO << "TCP Server received " << nread << " bytes from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << ")";
                         conn->OnDataReceived(buf->base, nread);
-                    } else {
+                    } else if (nread < 0) {
                         if (nread != UV_EOF && nread != UV_ECONNRESET) {
                             PLOG_ERROR << "TCP Server read error from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << "):" << uv_strerror(nread);
                         }
                         PLOG_INFO << "TCP Server connection closed from " << conn->ip_ << ":" << conn->port_ << " (ConnId: " << conn->conn_id_ << ")";
-                        uv_close((uv_handle_t*)stream, nullptr); // Close 由 read error 触发，逻辑在 Close() 内部处理
+                        // 对端已断开，丢弃未发送的数据并释放连接（触发 OnClose）
+                        conn->CloseImmediately();
                     }
+                    // nread == 0 表示 EAGAIN（如错误队列通知唤醒），仅归还缓冲区
                     // 将缓冲区归还到缓冲区池
                     server->buffer_pool_.ReleaseBuffer(buf->base);
                 }
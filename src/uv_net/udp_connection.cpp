@@ -9,8 +9,11 @@
 namespace uv_net {
 
 UdpConnection::UdpConnection(UdpServer* server, uv_udp_t* socket, const struct sockaddr* addr) 
-    : server_(server), socket_(socket), port_(0), conn_id_(0) {
-    memcpy(&addr_, addr, sizeof(addr_));
+    : server_(server), socket_(socket), listener_(socket), connected_(nullptr), port_(0), conn_id_(0), tracked_(false),
+      connect_failed_(false), last_active_(0), recent_packets_(0) {
+    // recvmmsg 模式下 addr 指向 libuv 的 sockaddr_in6 数组元素，只拷贝该地址族的长度
+    memset(&addr_, 0, sizeof(addr_));
+    memcpy(&addr_, addr, addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in));
     char ip_buf[64];
     if (addr->sa_family == AF_INET) {
         uv_ip4_name((const sockaddr_in*)addr, ip_buf, 64);
@@ -20,28 +23,15 @@ UdpConnection::UdpConnection(UdpServer* server, uv_udp_t* socket, const struct s
         port_ = ((const sockaddr_in6*)addr)->sin6_port;
     }
     ip_ = std::string(ip_buf);
-    PLOG_INFO << "UDP Connection created for " << ip_ << ":" << ntohs(port_);
+    PLOG_DEBUG << "UDP Connection created for " << ip_ << ":" << ntohs(port_);
 }
 
 void UdpConnection::Send(const char* data, size_t len) {
-    PLOG_INFO << "UDP Connection sending " << len << " bytes to " << ip_ << ":" << ntohs(port_);
-    uv_buf_t buf = uv_buf_init(new char[len], len);
-    memcpy(buf.base, data, len);
-    
-    uv_udp_send_t* req = new uv_udp_send_t();
-    // 存储 buffer 指针以便在回调中释放
-    req->data = buf.base;
-
-    uv_udp_send(req, socket_, &buf, 1, (const struct sockaddr*)&addr_, [](uv_udp_send_t* req, int status) {
-        delete[] (char*)req->data;
-        delete req;
-        if (status < 0) {
-             PLOG_ERROR << "UDP Send error: " << uv_strerror(status);
-        }
-    });
+    PLOG_DEBUG << "UDP Connection sending " << len << " bytes to " << ip_ << ":" << ntohs(port_);
+    server_->SendTo(socket_, (const struct sockaddr*)&addr_, data, len);
 }
 
-void UdpConnection::Close() {} // UDP 无连接，无操作
+void UdpConnection::Close() { server_->CloseSession(this); } // 移出会话表并触发 OnClose
 std::string UdpConnection::GetIP() { return ip_; }
 int UdpConnection::GetPort() { return ntohs(port_); }
 uint32_t UdpConnection::GetConnId() { return conn_id_; }
@@ -1,34 +1,193 @@
 #include "uv_net/udp_server.h"
 #include "uv_net/udp_connection.h"
+#include "uv_net/buffer_pool.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <plog/Log.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace uv_net {
 
-UdpServer::UdpServer(uv_loop_t* loop, const ServerConfig& config) : loop_(loop), config_(config), buffer_pool_(config.GetReadBufferSize()) {
+// libuv 按 64KB 把接收缓冲区切分为数据报槽位，一次 recvmmsg 最多 20 个
+static const size_t kUdpDatagramSlot = 64 * 1024;
+static const size_t kUdpRecvMmsgSlots = 20;
+
+// 发送缓冲区池的槽位大小：不超过它的数据报（以太网 MTU 内的常见情况）复用池中的缓冲区
+static const size_t kUdpSendSlot = 2048;
+// 一次 sendmmsg 的数据报数上限
+static const size_t kUdpSendMmsgBatch = 64;
+// 待发批次达到该数量时立即发出，不等到循环末尾
+static const size_t kUdpMaxOutbound = 1024;
+
+// 待发批次中的一个数据报，data 来自 Socket::AcquireSendBuffer
+struct UdpOutboundDatagram {
+    struct sockaddr_storage addr;
+    char* data;
+    size_t len;
+};
+
+// 交给 libuv 排队的发送请求，完成后回到所属 socket 的空闲列表复用
+struct UdpServer::SendRequest {
+    uv_udp_send_t req;
+    Socket* socket;
+    char* data;
+    size_t len;
+};
+
+// 会话表的键：对端地址族、端口与地址
+struct UdpPeerKey {
+    uint64_t addr[2];
+    uint32_t port_family;
+
+    bool operator==(const UdpPeerKey& other) const {
+        return addr[0] == other.addr[0] && addr[1] == other.addr[1] && port_family == other.port_family;
+    }
+};
+
+struct UdpPeerKeyHash {
+    size_t operator()(const UdpPeerKey& key) const {
+        uint64_t h = key.addr[0] * 0x9E3779B97F4A7C15ULL;
+        h ^= (key.addr[1] + key.port_family) * 0xC2B2AE3D27D4EB4FULL;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+static UdpPeerKey MakePeerKey(const struct sockaddr* addr) {
+    UdpPeerKey key;
+    key.addr[0] = 0;
+    key.addr[1] = 0;
+    if (addr->sa_family == AF_INET6) {
+        const sockaddr_in6* in6 = (const sockaddr_in6*)addr;
+        memcpy(key.addr, &in6->sin6_addr, sizeof(key.addr));
+        key.port_family = (static_cast<uint32_t>(AF_INET6) << 16) | in6->sin6_port;
+    } else {
+        const sockaddr_in* in = (const sockaddr_in*)addr;
+        key.addr[0] = in->sin_addr.s_addr;
+        key.port_family = (static_cast<uint32_t>(AF_INET) << 16) | in->sin_port;
+    }
+    return key;
+}
+
+// 一个 uv_udp_t 与它的接收缓冲区、待发批次：监听 socket，或热点对端专用的已连接 socket
+// 接收缓冲区只在接收回调期间被引用，整个 socket 复用同一块，不再逐个数据报从缓冲区池获取和归还
+struct UdpServer::Socket {
+    uv_udp_t handle;
+    UdpServer* server;
+    std::unique_ptr<char[]> recv_buffer;
+    size_t recv_buffer_size;
+    std::vector<UdpDatagram> batch;    // 本次 recvmmsg 已收到、尚未交付的数据报
+
+    // 已连接 socket 所属的监听 socket，与其共用接收缓冲区（同一 loop 上回调不会嵌套）和会话表
+    Socket* owner = nullptr;
+    bool connected = false;
+
+    // 会话表与过期检查定时器，只在监听 socket 所在的 loop 上访问
+    std::unordered_map<UdpPeerKey, std::shared_ptr<UdpConnection>, UdpPeerKeyHash> sessions;
+    uv_timer_t* expire_timer = nullptr;
+    int64_t expire_interval = 0;
+
+    // 发送合并：uv_check_t 在 poll 之后批量发送，uv_idle_t 保证 poll 不阻塞
+    uv_check_t* flush_check = nullptr;
+    uv_idle_t* flush_idle = nullptr;
+    std::vector<UdpOutboundDatagram> outbound;
+    // 发送缓冲区与请求只在本 socket 所在的 loop 上使用，随 socket 一起释放
+    BufferPool send_buffer_pool{kUdpSendSlot};
+    std::vector<SendRequest*> free_requests;
+
+    ~Socket() {
+        for (UdpOutboundDatagram& datagram : outbound) {
+            ReleaseSendBuffer(datagram.data, datagram.len);
+        }
+        for (SendRequest* req : free_requests) {
+            delete req;
+        }
+    }
+
+    // 不超过一个槽位的数据报复用池中的缓冲区
+    char* AcquireSendBuffer(size_t len) {
+        return len <= kUdpSendSlot ? send_buffer_pool.AcquireBuffer() : new char[len];
+    }
+    void ReleaseSendBuffer(char* data, size_t len) {
+        if (len <= kUdpSendSlot) {
+            send_buffer_pool.ReleaseBuffer(data);
+        } else {
+            delete[] data;
+        }
+    }
+};
+
+// 工作线程：独立的 loop 与 SO_REUSEPORT 监听 socket
+struct UdpServer::Worker {
+    uv_loop_t loop;
+    uv_thread_t thread;
+    uv_async_t stop;        // 在工作线程中关闭监听 socket，loop 随之退出
+    UdpServer* server = nullptr;
+    Socket* socket = nullptr;
+    int cpu = -1;           // 绑定的 CPU，-1 为不绑定
+    bool running = false;
+};
+
+thread_local UdpServer::Socket* UdpServer::current_listener_ = nullptr;
+
+static void SetReusePort(uv_handle_t* handle) {
+    int fd;
+    if (uv_fileno(handle, &fd) == 0) {
+        int opt = 1;
+#ifdef SO_REUSEPORT
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+#endif
+    }
+}
+
+static void PinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    int r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (r != 0) {
+        PLOG_WARNING << "UDP Server worker CPU affinity failed: " << strerror(r);
+    }
+#else
+    PLOG_WARNING << "UDP Server worker CPU affinity is only supported on Linux";
+#endif
+}
+
+static socklen_t SockaddrLen(const struct sockaddr* addr) {
+    return addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+}
+
+UdpServer::UdpServer(uv_loop_t* loop, const ServerConfig& config)
+    : loop_(loop), config_(config), recv_mmsg_(true), socket_recv_buffer_size_(0), hot_peer_threshold_(0),
+      worker_count_(1), worker_cpu_affinity_(false) {
     PLOG_INFO << "UDP Server created";
 } // 构造函数，接受loop和config参数
 
 void UdpServer::OnMessage(std::shared_ptr<Connection> conn, const char* data, size_t len) {
     if (on_message_) {
-        PLOG_INFO << "UDP Server received message of " << len << " bytes";
-        
+        PLOG_DEBUG << "UDP Server received message of " << len << " bytes";
+
         // 获取协议解析器
         auto protocol = GetServerProtocol();
-        
+
         // 如果没有配置协议解析器，直接调用OnMessage
         if (!protocol) {
             on_message_(conn, data, len);
             return;
         }
-        
+
         // 使用协议解析器解析数据
         int package_len = 0;
         int msg_len = 0;
         PackageStatus status = protocol->ParsePackage(data, len, package_len, msg_len);
-        
+
         if (status == PackageFull) {
             // 完整包，调用OnMessage
             on_message_(conn, data, package_len);
@@ -40,59 +199,516 @@ void UdpServer::OnMessage(std::shared_ptr<Connection> conn, const char* data, si
     }
 }
 
+void UdpServer::DispatchBatch(Socket* socket) {
+    std::vector<UdpDatagram>& batch = socket->batch;
+    if (batch.empty()) {
+        return;
+    }
+    Socket* listener = socket->owner ? socket->owner : socket;
+    Socket* previous = current_listener_;
+    current_listener_ = listener;
+    if (!on_message_batch_) {
+        for (const UdpDatagram& datagram : batch) {
+            OnMessage(FindSession(listener, datagram.addr), datagram.data, datagram.len);
+        }
+        batch.clear();
+        current_listener_ = previous;
+        return;
+    }
+
+    // 与 OnMessage 相同的协议处理：只保留完整包并截到包长
+    if (server_protocol_) {
+        size_t kept = 0;
+        for (const UdpDatagram& datagram : batch) {
+            int package_len = 0;
+            int msg_len = 0;
+            PackageStatus status = server_protocol_->ParsePackage(datagram.data, datagram.len, package_len, msg_len);
+            if (status == PackageFull) {
+                batch[kept] = datagram;
+                batch[kept].len = static_cast<size_t>(package_len);
+                kept++;
+            } else if (status == PackageError) {
+                PLOG_ERROR << "UDP Server package parse error";
+            }
+        }
+        batch.resize(kept);
+    }
+    if (!batch.empty()) {
+        on_message_batch_(batch.data(), batch.size());
+    }
+    batch.clear();
+    current_listener_ = previous;
+}
+
+std::shared_ptr<UdpConnection> UdpServer::FindSession(Socket* listener, const struct sockaddr* addr) {
+    UdpPeerKey key = MakePeerKey(addr);
+    auto it = listener->sessions.find(key);
+    if (it != listener->sessions.end()) {
+        UdpConnection* conn = it->second.get();
+        conn->last_active_ = uv_now(listener->handle.loop);
+        conn->recent_packets_++;
+        return it->second;
+    }
+
+    std::shared_ptr<UdpConnection> conn = std::make_shared<UdpConnection>(this, &listener->handle, addr);
+    if (current_connections_ >= GetMaxConnections()) {
+        // 会话表已满：临时对象只用于本数据报，连接ID为0，不触发 OnOpen/OnClose
+        PLOG_DEBUG << "UDP Server session limit reached: " << GetMaxConnections();
+        return conn;
+    }
+    conn->conn_id_ = ++conn_id_counter_;
+    conn->tracked_ = true;
+    conn->last_active_ = uv_now(listener->handle.loop);
+    conn->recent_packets_ = 1;
+    listener->sessions.emplace(key, conn);
+    current_connections_++;
+    PLOG_DEBUG << "UDP Server session opened for " << conn->ip_ << ":" << conn->GetPort() << " (ConnId: " << conn->conn_id_ << ")";
+    if (on_open_) {
+        on_open_(conn);
+    }
+    return conn;
+}
+
+void UdpServer::CloseSession(UdpConnection* conn) {
+    if (!conn->tracked_) {
+        return;
+    }
+    Socket* listener = static_cast<Socket*>(conn->listener_->data);
+    auto it = listener->sessions.find(MakePeerKey((const struct sockaddr*)&conn->addr_));
+    if (it == listener->sessions.end() || it->second.get() != conn) {
+        return;
+    }
+    std::shared_ptr<UdpConnection> holder = std::move(it->second);
+    listener->sessions.erase(it);
+    FinishSession(holder);
+}
+
+void UdpServer::FinishSession(const std::shared_ptr<UdpConnection>& conn) {
+    conn->tracked_ = false;
+    DisconnectPeer(conn.get());
+    if (current_connections_ > 0) {
+        current_connections_--;
+    }
+    PLOG_DEBUG << "UDP Server session closed for " << conn->ip_ << ":" << conn->GetPort() << " (ConnId: " << conn->conn_id_ << ")";
+    if (on_close_) {
+        on_close_(conn);
+    }
+}
+
+void UdpServer::ExpireSessions(Socket* listener) {
+    uint64_t now = uv_now(listener->handle.loop);
+    int64_t timeout = GetConnectionReadTimeout();
+    uint64_t hot_packets = 0;
+    if (hot_peer_threshold_ > 0) {
+        hot_packets = std::max<uint64_t>(1, static_cast<uint64_t>(hot_peer_threshold_) * listener->expire_interval / 1000);
+    }
+
+    // 先移出会话表再回调，OnClose 中关闭其他会话不会影响遍历
+    std::vector<std::shared_ptr<UdpConnection>> expired;
+    for (auto it = listener->sessions.begin(); it != listener->sessions.end();) {
+        UdpConnection* conn = it->second.get();
+        if (timeout > 0 && now - conn->last_active_ > static_cast<uint64_t>(timeout)) {
+            expired.push_back(std::move(it->second));
+            it = listener->sessions.erase(it);
+            continue;
+        }
+        if (hot_packets > 0 && conn->recent_packets_ >= hot_packets && !conn->connected_ && !conn->connect_failed_) {
+            ConnectPeer(listener, conn);
+        }
+        conn->recent_packets_ = 0;
+        ++it;
+    }
+    Socket* previous = current_listener_;
+    current_listener_ = listener;
+    for (const std::shared_ptr<UdpConnection>& conn : expired) {
+        PLOG_DEBUG << "UDP Server session idle timeout (ConnId: " << conn->conn_id_ << ")";
+        FinishSession(conn);
+    }
+    current_listener_ = previous;
+}
+
+void UdpServer::ConnectPeer(Socket* listener, UdpConnection* conn) {
+    // 与监听 socket 绑定同一地址后 connect 到对端：内核把该对端的数据报交给更精确匹配的已连接 socket，
+    // 发送时不再逐个数据报查找路由，回复的源端口仍是服务端口
+    struct sockaddr_storage local;
+    int namelen = sizeof(local);
+    if (uv_udp_getsockname(&listener->handle, (struct sockaddr*)&local, &namelen) != 0) {
+        conn->connect_failed_ = true;
+        return;
+    }
+    Socket* socket = new Socket();
+    socket->server = this;
+    socket->owner = listener;
+    socket->connected = true;
+    socket->handle.data = socket;
+    uv_udp_init(listener->handle.loop, &socket->handle);
+
+    int r = uv_udp_bind(&socket->handle, (const struct sockaddr*)&local, UV_UDP_REUSEADDR);
+    if (r == 0) {
+        r = uv_udp_connect(&socket->handle, (const struct sockaddr*)&conn->addr_);
+    }
+    if (r == 0) {
+        if (socket_recv_buffer_size_ > 0) {
+            int size = socket_recv_buffer_size_;
+            uv_recv_buffer_size((uv_handle_t*)&socket->handle, &size);
+        }
+        r = uv_udp_recv_start(&socket->handle, AllocCallback, RecvCallback);
+    }
+    if (r != 0) {
+        PLOG_WARNING << "UDP Server connected socket for " << conn->ip_ << ":" << conn->GetPort() << " failed: " << uv_strerror(r);
+        conn->connect_failed_ = true;
+        CloseSocket(socket);
+        return;
+    }
+    conn->connected_ = &socket->handle;
+    conn->socket_ = &socket->handle;
+    PLOG_INFO << "UDP Server hot peer " << conn->ip_ << ":" << conn->GetPort() << " (ConnId: " << conn->conn_id_ << ") uses a connected socket";
+}
+
+void UdpServer::DisconnectPeer(UdpConnection* conn) {
+    if (!conn->connected_) {
+        return;
+    }
+    Socket* socket = static_cast<Socket*>(conn->connected_->data);
+    conn->socket_ = conn->listener_;
+    conn->connected_ = nullptr;
+    CloseSocket(socket);
+}
+
+void UdpServer::CloseSocket(Socket* socket) {
+    if (!socket->outbound.empty()) {
+        FlushSend(socket);
+    }
+    if (socket->flush_check) {
+        uv_close((uv_handle_t*)socket->flush_check, [](uv_handle_t* h) { delete (uv_check_t*)h; });
+        uv_close((uv_handle_t*)socket->flush_idle, [](uv_handle_t* h) { delete (uv_idle_t*)h; });
+    }
+    if (socket->expire_timer) {
+        uv_close((uv_handle_t*)socket->expire_timer, [](uv_handle_t* h) { delete (uv_timer_t*)h; });
+    }
+    // 关闭时 libuv 以 UV_ECANCELED 完成排队中的发送，之后才调用关闭回调
+    uv_close((uv_handle_t*)&socket->handle, [](uv_handle_t* h) { delete (Socket*)h->data; });
+}
+
+void UdpServer::AllocCallback(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    Socket* socket = static_cast<Socket*>(handle->data);
+    Socket* owner = socket->owner ? socket->owner : socket;
+    buf->base = owner->recv_buffer.get();
+    buf->len = owner->recv_buffer_size;
+}
+
+void UdpServer::RecvCallback(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags) {
+    Socket* socket = static_cast<Socket*>(handle->data);
+    if (nread < 0) {
+        PLOG_ERROR << "UDP Server recv error: " << uv_strerror(nread);
+        return;
+    }
+    if (nread > 0 && addr) {
+        // recvmmsg 模式下 addr 指向 libuv 栈上的地址数组，在本轮最后一次回调之前都有效
+        socket->batch.push_back(UdpDatagram{addr, buf->base, static_cast<size_t>(nread)});
+    }
+    // UV_UDP_MMSG_CHUNK：本轮 recvmmsg 还有后续数据报，随后以 nread == 0 的回调结束
+    if (flags & UV_UDP_MMSG_CHUNK) {
+        return;
+    }
+    socket->server->DispatchBatch(socket);
+}
+
+void UdpServer::SendTo(const struct sockaddr* addr, const char* data, size_t len) {
+    Socket* socket = current_listener_;
+    if (!socket || socket->server != this) {
+        // 回调之外：工作线程模式下各 socket 属于其他线程的 loop，不能在这里使用
+        if (sockets_.empty()) {
+            PLOG_ERROR << "UDP Server SendTo outside a receive callback requires a started single-loop server";
+            return;
+        }
+        socket = sockets_.front();
+    }
+    SendTo(&socket->handle, addr, data, len);
+}
+
+void UdpServer::SendTo(uv_udp_t* handle, const struct sockaddr* addr, const char* data, size_t len) {
+    Socket* socket = static_cast<Socket*>(handle->data);
+    // 已连接 socket 不能再指定目的地址
+    if (socket->connected) {
+        addr = nullptr;
+    }
+    if (config_.GetAutoFlush()) {
+        if (socket->outbound.empty()) {
+            ScheduleFlush(socket);
+        }
+        UdpOutboundDatagram datagram;
+        if (addr) {
+            memcpy(&datagram.addr, addr, SockaddrLen(addr));
+        }
+        datagram.data = socket->AcquireSendBuffer(len);
+        datagram.len = len;
+        memcpy(datagram.data, data, len);
+        socket->outbound.push_back(datagram);
+        if (socket->outbound.size() >= kUdpMaxOutbound) {
+            FlushSend(socket);
+        }
+        return;
+    }
+
+    // libuv 队列中还有数据报时 uv_udp_try_send 返回 UV_EAGAIN，保证顺序
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data), static_cast<unsigned int>(len));
+    int r = uv_udp_try_send(handle, &buf, 1, addr);
+    if (r >= 0) {
+        return;
+    }
+    if (r != UV_EAGAIN) {
+        PLOG_ERROR << "UDP Send error: " << uv_strerror(r);
+        return;
+    }
+    char* copy = socket->AcquireSendBuffer(len);
+    memcpy(copy, data, len);
+    QueueSend(socket, addr, copy, len);
+}
+
+void UdpServer::QueueSend(Socket* socket, const struct sockaddr* addr, char* data, size_t len) {
+    SendRequest* req;
+    if (socket->free_requests.empty()) {
+        req = new SendRequest();
+        req->socket = socket;
+        req->req.data = req;
+    } else {
+        req = socket->free_requests.back();
+        socket->free_requests.pop_back();
+    }
+    req->data = data;
+    req->len = len;
+
+    uv_buf_t buf = uv_buf_init(data, static_cast<unsigned int>(len));
+    int r = uv_udp_send(&req->req, &socket->handle, &buf, 1, addr, [](uv_udp_send_t* handle, int status) {
+        SendRequest* req = static_cast<SendRequest*>(handle->data);
+        Socket* socket = req->socket;
+        socket->ReleaseSendBuffer(req->data, req->len);
+        socket->free_requests.push_back(req);
+        if (status < 0 && status != UV_ECANCELED) {
+            PLOG_ERROR << "UDP Send error: " << uv_strerror(status);
+        }
+    });
+    if (r != 0) {
+        PLOG_ERROR << "UDP Send error: " << uv_strerror(r);
+        socket->ReleaseSendBuffer(data, len);
+        socket->free_requests.push_back(req);
+    }
+}
+
+void UdpServer::ScheduleFlush(Socket* socket) {
+    if (!socket->flush_check) {
+        socket->flush_check = new uv_check_t();
+        uv_check_init(socket->handle.loop, socket->flush_check);
+        socket->flush_check->data = socket;
+        socket->flush_idle = new uv_idle_t();
+        uv_idle_init(socket->handle.loop, socket->flush_idle);
+    }
+    uv_check_start(socket->flush_check, [](uv_check_t* handle) {
+        Socket* socket = static_cast<Socket*>(handle->data);
+        socket->server->FlushSend(socket);
+    });
+    // 活跃的 idle 句柄使 poll 超时为 0，定时器等回调中的发送不会等到下一次 IO
+    uv_idle_start(socket->flush_idle, [](uv_idle_t*) {});
+}
+
+void UdpServer::FlushSend(Socket* socket) {
+    uv_check_stop(socket->flush_check);
+    uv_idle_stop(socket->flush_idle);
+    std::vector<UdpOutboundDatagram>& outbound = socket->outbound;
+    size_t sent = 0;
+
+#ifdef __linux__
+    // libuv 队列为空时才直接写 socket，否则交给 libuv 排在已有数据报之后
+    uv_os_fd_t fd;
+    if (socket->handle.send_queue_count == 0 && uv_fileno((uv_handle_t*)&socket->handle, &fd) == 0) {
+        struct mmsghdr msgs[kUdpSendMmsgBatch];
+        struct iovec iov[kUdpSendMmsgBatch];
+        while (sent < outbound.size()) {
+            size_t count = std::min(outbound.size() - sent, kUdpSendMmsgBatch);
+            for (size_t i = 0; i < count; ++i) {
+                UdpOutboundDatagram& datagram = outbound[sent + i];
+                iov[i].iov_base = datagram.data;
+                iov[i].iov_len = datagram.len;
+                memset(&msgs[i], 0, sizeof(msgs[i]));
+                if (!socket->connected) {
+                    msgs[i].msg_hdr.msg_name = &datagram.addr;
+                    msgs[i].msg_hdr.msg_namelen = SockaddrLen((const struct sockaddr*)&datagram.addr);
+                }
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            int n;
+            do {
+                n = sendmmsg(fd, msgs, static_cast<unsigned int>(count), 0);
+            } while (n < 0 && errno == EINTR);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                    break;
+                }
+                // 第一个数据报发送失败（如目的地址不可达），丢弃它后继续
+                PLOG_ERROR << "UDP sendmmsg error: " << strerror(errno);
+                n = 1;
+            }
+            for (int i = 0; i < n; ++i) {
+                socket->ReleaseSendBuffer(outbound[sent + i].data, outbound[sent + i].len);
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+#endif
+
+    // 内核缓冲区已满或不支持 sendmmsg：剩余部分由 libuv 在可写时发送
+    for (size_t i = sent; i < outbound.size(); ++i) {
+        const struct sockaddr* addr = socket->connected ? nullptr : (const struct sockaddr*)&outbound[i].addr;
+        QueueSend(socket, addr, outbound[i].data, outbound[i].len);
+    }
+    outbound.clear();
+}
+
 UdpServer::~UdpServer() {
     PLOG_INFO << "UDP Server destroying";
-    for (auto s : sockets_) { 
-        uv_close((uv_handle_t*)s, nullptr); 
-        delete s; 
+    StopWorkers();
+    for (auto s : sockets_) {
+        CloseListener(s);
     }
     // 不关闭loop，因为loop是外部传入的
     PLOG_INFO << "UDP Server destroyed";
 }
 
+void UdpServer::CloseListener(Socket* listener) {
+    for (auto& session : listener->sessions) {
+        DisconnectPeer(session.second.get());
+    }
+    CloseSocket(listener);
+}
+
+UdpServer::Socket* UdpServer::CreateListener(uv_loop_t* loop, const struct sockaddr* addr, bool reuse_port) {
+    Socket* socket = new Socket();
+    socket->server = this;
+    socket->handle.data = socket;
+    if (recv_mmsg_) {
+        // 内核不支持 recvmmsg 时 libuv 自动退回逐个 recvmsg，每个数据报单独交付
+        uv_udp_init_ex(loop, &socket->handle, AF_INET | UV_UDP_RECVMMSG);
+        socket->recv_buffer_size = kUdpDatagramSlot * kUdpRecvMmsgSlots;
+        socket->batch.reserve(kUdpRecvMmsgSlots);
+    } else {
+        uv_udp_init_ex(loop, &socket->handle, AF_INET);
+        socket->recv_buffer_size = GetReadBufferSize();
+        socket->batch.reserve(1);
+    }
+    socket->recv_buffer.reset(new char[socket->recv_buffer_size]);
+    if (reuse_port) {
+        SetReusePort((uv_handle_t*)&socket->handle);
+    }
+
+    if (uv_udp_bind(&socket->handle, addr, UV_UDP_REUSEADDR) != 0) {
+        uv_close((uv_handle_t*)&socket->handle, [](uv_handle_t* h) { delete (Socket*)h->data; });
+        return nullptr;
+    }
+    if (socket_recv_buffer_size_ > 0) {
+        int size = socket_recv_buffer_size_;
+        uv_recv_buffer_size((uv_handle_t*)&socket->handle, &size);
+    }
+
+    uv_udp_recv_start(&socket->handle, AllocCallback, RecvCallback);
+
+    // 会话过期检查：间隔为空闲超时的 1/4，不超过 1 秒
+    int64_t timeout = GetConnectionReadTimeout();
+    if (timeout > 0 || hot_peer_threshold_ > 0) {
+        socket->expire_interval = timeout > 0 ? std::min<int64_t>(1000, std::max<int64_t>(10, timeout / 4)) : 1000;
+        socket->expire_timer = new uv_timer_t();
+        uv_timer_init(loop, socket->expire_timer);
+        socket->expire_timer->data = socket;
+        uv_timer_start(socket->expire_timer, [](uv_timer_t* timer) {
+            Socket* socket = static_cast<Socket*>(timer->data);
+            socket->server->ExpireSessions(socket);
+        }, socket->expire_interval, socket->expire_interval);
+    }
+    return socket;
+}
+
 bool UdpServer::Start(const std::string& ip, int port) {
     PLOG_INFO << "UDP Server starting on " << ip << ":" << port;
-    
-    // 单线程模式：直接使用传入的loop
-    uv_udp_t* socket = new uv_udp_t();
-    uv_udp_init(loop_, socket);
-    
+
     struct sockaddr_in addr;
     uv_ip4_addr(ip.c_str(), port, &addr);
-    
-    if (uv_udp_bind(socket, (const struct sockaddr*)&addr, UV_UDP_REUSEADDR) != 0) {
+
+    if (worker_count_ > 1) {
+        if (!StartWorkers((const struct sockaddr*)&addr)) {
+            PLOG_ERROR << "UDP Server bind failed on " << ip << ":" << port;
+            return false;
+        }
+        PLOG_INFO << "UDP Server started on " << ip << ":" << port << " with " << worker_count_ << " workers"
+                  << (recv_mmsg_ ? " (recvmmsg)" : "");
+        return true;
+    }
+
+    // 单线程模式：直接使用传入的loop
+    Socket* socket = CreateListener(loop_, (const struct sockaddr*)&addr, false);
+    if (!socket) {
         PLOG_ERROR << "UDP Server bind failed on " << ip << ":" << port;
-        delete socket;
         return false;
     }
-    
-    socket->data = this;
-    
-    uv_udp_recv_start(socket, 
-        [](uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
-            UdpServer* server = (UdpServer*)handle->data;
-            // 从缓冲区池获取缓冲区
-            buf->base = server->buffer_pool_.AcquireBuffer();
-            buf->len = server->GetReadBufferSize();
-        },
-        [](uv_udp_t* socket, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags) {
-            if (nread > 0 && addr) {
-                UdpServer* server = (UdpServer*)socket->data;
-                PLOG_INFO << "UDP Server received " << nread << " bytes";
-                std::shared_ptr<UdpConnection> conn = std::make_shared<UdpConnection>(server, socket, addr);
-                server->OnMessage(conn, buf->base, nread);
-            } else if (nread < 0) {
-                PLOG_ERROR << "UDP Server recv error: " << uv_strerror(nread);
-            }
-            // 归还缓冲区到缓冲区池
-            UdpServer* server = (UdpServer*)socket->data;
-            server->buffer_pool_.ReleaseBuffer(buf->base);
-        }
-    );
-    
     sockets_.push_back(socket);
-    PLOG_INFO << "UDP Server started on " << ip << ":" << port;
+    PLOG_INFO << "UDP Server started on " << ip << ":" << port << (recv_mmsg_ ? " (recvmmsg)" : "");
+    return true;
+}
+
+bool UdpServer::StartWorkers(const struct sockaddr* addr) {
+    unsigned int cpus = uv_available_parallelism();
+    // 先在当前线程绑定全部 socket，都成功后再启动线程；线程启动前 loop 只在当前线程访问
+    for (int i = 0; i < worker_count_; ++i) {
+        Worker* worker = new Worker();
+        worker->server = this;
+        uv_loop_init(&worker->loop);
+        worker->socket = CreateListener(&worker->loop, addr, true);
+        if (!worker->socket) {
+            uv_run(&worker->loop, UV_RUN_DEFAULT);
+            uv_loop_close(&worker->loop);
+            delete worker;
+            StopWorkers();
+            return false;
+        }
+        worker->cpu = worker_cpu_affinity_ ? static_cast<int>(i % cpus) : -1;
+        worker->stop.data = worker;
+        uv_async_init(&worker->loop, &worker->stop, [](uv_async_t* handle) {
+            Worker* worker = static_cast<Worker*>(handle->data);
+            worker->server->CloseListener(worker->socket);
+            uv_close((uv_handle_t*)handle, nullptr);
+        });
+        workers_.push_back(worker);
+    }
+    for (Worker* worker : workers_) {
+        uv_thread_create(&worker->thread, WorkerMain, worker);
+        worker->running = true;
+    }
     return true;
 }
 
-} // namespace uv_net
\ No newline at end of file
+void UdpServer::WorkerMain(void* arg) {
+    Worker* worker = static_cast<Worker*>(arg);
+    if (worker->cpu >= 0) {
+        PinCurrentThread(worker->cpu);
+    }
+    // 监听 socket 与它的已连接 socket、定时器全部关闭后 uv_run 返回
+    uv_run(&worker->loop, UV_RUN_DEFAULT);
+}
+
+void UdpServer::StopWorkers() {
+    for (Worker* worker : workers_) {
+        if (worker->running) {
+            uv_async_send(&worker->stop);
+            uv_thread_join(&worker->thread);
+        } else {
+            CloseListener(worker->socket);
+            uv_close((uv_handle_t*)&worker->stop, nullptr);
+            uv_run(&worker->loop, UV_RUN_DEFAULT);
+        }
+        uv_loop_close(&worker->loop);
+        delete worker;
+    }
+    workers_.clear();
+}
+
+} // namespace uv_net
@@ -1,71 +1,24 @@
 #include "uv_net/websocket_connection.h"
 #include "uv_net/websocket_server.h"
+#include "uv_net/websocket_handshake.h"
+#include "uv_net/simd.h"
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
-#include <openssl/sha.h> // for SHA-1
-#include <openssl/bio.h> // for BIO functions
-#include <openssl/evp.h> // for EVP functions
 #include <plog/Log.h>
 
 namespace uv_net {
 
-static std::string Base64Encode(const unsigned char* data, size_t len) {
-    static const char base64_chars[] = 
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-    
-    std::string ret;
-    int i = 0;
-    int j = 0;
-    unsigned char char_array_3[3];
-    unsigned char char_array_4[4];
-    
-    while (len--) {
-        char_array_3[i++] = *(data++);
-        if (i == 3) {
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-            
-            for(i = 0; (i <4) ; i++)
-                ret += base64_chars[char_array_4[i]];
-            i = 0;
-        }
-    }
-    
-    if (i) {
-        for(j = i; j < 3; j++)
-            char_array_3[j] = '\0';
-            
-        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-        char_array_4[3] = char_array_3[2] & 0x3f;
-        
-        for (j = 0; (j < i + 1); j++)
-            ret += base64_chars[char_array_4[j]];
-            
-        while((i++ < 3))
-            ret += '=';
-    }
-    
-    return ret;
-}
-
 WebSocketConnection::WebSocketConnection(WebSocketServer* server)
-    : TcpConnection(server), state_(State::HANDSHAKE),
-      parse_state_(ParseState::READ_HEADER), current_frame_(),
-      bytes_read_(0) {
+    : TcpConnection(server), state_(State::HANDSHAKE), handshake_scanned_(0), handshake_responded_(false),
+      in_message_(false), message_opcode_(WebSocketOpcode::TEXT), message_size_(0),
+      message_streaming_(false), chunk_first_(false), stream_frame_(), stream_remaining_(0), stream_offset_(0),
+      message_compressed_(false), ping_sent_ns_(0), missed_pongs_(0) {
     // 将服务器指针转换为WebSocketServer类型
     server_ = server;
     
-    memset(&current_frame_, 0, sizeof(current_frame_));
-    
     PLOG_INFO << "WebSocket Connection created";
 }
 
@@ -75,66 +28,99 @@ WebSocketConnection::~WebSocketConnection() {
 }
 
 // WebSocket 握手相关方法
-std::string WebSocketConnection::GenerateResponseKey(const std::string& sec_websocket_key) {
-    const std::string magic_string = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
-    std::string combined = sec_websocket_key + magic_string;
-    
-    // 计算 SHA-1
-    unsigned char sha1_hash[SHA_DIGEST_LENGTH];
-    SHA1(reinterpret_cast<const unsigned char*>(combined.c_str()), combined.size(), sha1_hash);
-    
-    // 进行 Base64 编码
-    std::string response_key = Base64Encode(sha1_hash, SHA_DIGEST_LENGTH);
-    
-    return response_key;
-}
-
-bool WebSocketConnection::ParseHandshake(const std::string& handshake_data) {
+bool WebSocketConnection::ParseHandshake(const char* data, size_t head_len) {
     PLOG_INFO << "WebSocket Connection parsing handshake";
-    // 简单的握手解析，提取 Sec-WebSocket-Key
-    size_t key_pos = handshake_data.find("Sec-WebSocket-Key: ");
-    if (key_pos == std::string::npos) {
-        PLOG_ERROR << "WebSocket Connection handshake failed: missing Sec-WebSocket-Key";
+    WebSocketUpgradeRequest request;
+    int status = ParseWebSocketUpgrade(data, head_len, request);
+    if (status != 0) {
+        PLOG_ERROR << "WebSocket Connection " << conn_id_ << " handshake failed: invalid upgrade request, status " << status;
+        RejectHandshake(status);
         return false;
     }
-    
-    size_t key_end = handshake_data.find("\r\n", key_pos);
-    if (key_end == std::string::npos) {
-        PLOG_ERROR << "WebSocket Connection handshake failed: invalid Sec-WebSocket-Key format";
+
+    WebSocketServer* server = GetWebSocketServer();
+    char accept[kWebSocketAcceptSize];
+    ComputeWebSocketAccept(request.key, accept);
+    StringView protocol = SelectWebSocketProtocol(request.protocols, server->subprotocols_);
+
+    // permessage-deflate：接受客户端第一个可接受的提议
+    std::string extensions;
+    WebSocketDeflateParams deflate_params;
+    if (server->deflate_options_.enabled && !request.extensions.Empty() &&
+        NegotiateWebSocketDeflate(request.extensions, server->deflate_options_, deflate_params, extensions)) {
+        deflate_.reset(new WebSocketDeflate(deflate_params, server->deflate_options_, &server->deflate_memory_));
+    }
+
+    // 响应在栈上生成，通常一次 uv_try_write 即可写完
+    char response[kWebSocketMaxResponseSize];
+    size_t response_len = BuildWebSocketHandshakeResponse(response, sizeof(response), accept, protocol, extensions);
+    if (response_len == 0) {
+        PLOG_ERROR << "WebSocket Connection " << conn_id_ << " handshake failed: response too large";
+        RejectHandshake(400);
         return false;
     }
-    
-    std::string sec_websocket_key = handshake_data.substr(key_pos + 19, key_end - (key_pos + 19));
+    subprotocol_ = protocol.ToString();
+
     PLOG_INFO << "WebSocket Connection sending handshake response";
-    SendHandshakeResponse(sec_websocket_key);
+    SendHandshakeResponse(response, response_len);
     return true;
 }
 
-void WebSocketConnection::SendHandshakeResponse(const std::string& sec_websocket_key) {
-    std::string response_key = GenerateResponseKey(sec_websocket_key);
-    
-    std::string response = "HTTP/1.1 101 Switching Protocols\r\n";
-    response += "Upgrade: websocket\r\n";
-    response += "Connection: Upgrade\r\n";
-    response += "Sec-WebSocket-Accept: " + response_key + "\r\n\r\n";
-    
-    // 发送握手响应
-    uv_buf_t buf = uv_buf_init(const_cast<char*>(response.c_str()), response.size());
-    uv_write_t* req = new uv_write_t();
-    req->data = this;
-    
-    uv_write(req, (uv_stream_t*)&handle_, &buf, 1, [](uv_write_t* uv_req, int status) {
-        WebSocketConnection* conn = static_cast<WebSocketConnection*>(uv_req->data);
-        delete uv_req;
+void WebSocketConnection::SendHandshakeResponse(const char* data, size_t len) {
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data), len);
+    int r = uv_try_write((uv_stream_t*)&handle_, &buf, 1);
+    if (r == static_cast<int>(len)) {
+        OnHandshakeComplete();
+        return;
+    }
+    if (r < 0 && r != UV_EAGAIN) {
+        PLOG_ERROR << "WebSocket Connection " << conn_id_ << " handshake write failed: " << uv_strerror(r);
+        Close();
+        return;
+    }
+
+    // 发送缓冲区已满（少见）：剩余部分拷贝后异步写出，写完成后再进入 OPEN 状态
+    size_t written = r > 0 ? static_cast<size_t>(r) : 0;
+    WriteReq* req = new WriteReq();
+    req->req.data = this;
+    req->data.assign(data + written, len - written);
+    buf = uv_buf_init(&req->data[0], req->data.size());
+    r = uv_write(&req->req, (uv_stream_t*)&handle_, &buf, 1, [](uv_write_t* uv_req, int status) {
+        WriteReq* wr = reinterpret_cast<WriteReq*>(uv_req);
+        WebSocketConnection* conn = static_cast<WebSocketConnection*>(wr->req.data);
+        delete wr;
+        if (status == UV_ECANCELED) {
+            return;
+        }
+        if (status < 0) {
+            PLOG_ERROR << "WebSocket Connection " << conn->conn_id_ << " handshake write failed: " << uv_strerror(status);
+            conn->Close();
+            return;
+        }
         conn->OnHandshakeComplete();
     });
+    if (r != 0) {
+        PLOG_ERROR << "WebSocket Connection " << conn_id_ << " handshake write failed: " << uv_strerror(r);
+        delete req;
+        Close();
+    }
+}
+
+void WebSocketConnection::RejectHandshake(int status) {
+    // 尽力写出错误响应后关闭连接
+    char response[kWebSocketMaxResponseSize];
+    size_t len = BuildWebSocketRejectResponse(response, sizeof(response), status);
+    uv_buf_t buf = uv_buf_init(response, len);
+    uv_try_write((uv_stream_t*)&handle_, &buf, 1);
+    Close();
 }
 
 void WebSocketConnection::OnHandshakeComplete() {
     state_ = State::OPEN;
     PLOG_INFO << "WebSocket Connection handshake completed, connection open";
     
-    // 启动心跳机制
+    // 握手超时定时器切换为心跳
+    StopHeartbeat();
     StartHeartbeat();
     
     // 触发用户层的 OnOpen
@@ -142,228 +128,445 @@ void WebSocketConnection::OnHandshakeComplete() {
         std::shared_ptr<WebSocketConnection> shared_conn(this, [](WebSocketConnection*){});
         server_->OnNewConnection(shared_conn);
     }
+
+    // 握手完成前已到达的帧
+    ParsePending();
 }
 
 // WebSocket 帧处理方法
-void WebSocketConnection::SendFrame(const char* data, size_t len, uint8_t opcode) {
-    std::string frame;
-    
-    // 第1字节：FIN + RSV + OPCODE
-    uint8_t first_byte = (1 << 7) | (opcode & 0x0F);
-    frame.push_back(first_byte);
-    
-    // 第2字节：MASK + PAYLOAD_LENGTH
-    uint8_t second_byte = 0; // 服务器发送的数据不使用掩码
-    
-    if (len < 126) {
-        second_byte |= static_cast<uint8_t>(len);
-        frame.push_back(second_byte);
-    } else if (len < 65536) {
-        second_byte |= 126;
-        frame.push_back(second_byte);
-        uint16_t len16 = htons(static_cast<uint16_t>(len));
-        frame.append(reinterpret_cast<const char*>(&len16), 2);
-    } else {
-        second_byte |= 127;
-        frame.push_back(second_byte);
-        uint64_t len64 = htobe64(static_cast<uint64_t>(len));
-        frame.append(reinterpret_cast<const char*>(&len64), 8);
+void WebSocketConnection::SendFrame(const char* data, size_t len, WebSocketOpcode opcode) {
+    if (!IsControlOpcode(opcode) && SendCompressed(data, len, opcode)) {
+        return;
     }
-    
-    // 有效负载数据
-    frame.append(data, len);
-    
-    // 发送帧
-    {    std::lock_guard<std::mutex> lock(send_mutex_);
-        send_queue_.push(frame);
+
+    size_t fragment_size = GetWebSocketServer()->fragment_size_;
+    if (fragment_size > 0 && !IsControlOpcode(opcode) && len > fragment_size) {
+        // 调用方的内存不能保留到最后一片发出，拷贝一次后逐片发送
+        QueueMessage(std::make_shared<SendItem>(data, len), opcode, 0);
+        return;
+    }
+
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, true, opcode, len);
+
+    // 排队中的帧未发出时不能直接写出，否则会越过它们
+    if (len < kDirectWriteThreshold || HasQueuedFrames()) {
+        // 小帧拷贝成一块连续内存入队，连续发送的多个帧在写完成前排队，由 writev 合并
+        std::string frame;
+        frame.reserve(header_len + len);
+        frame.append(header, header_len);
+        frame.append(data, len);
+        QueueFrame(SendItem(std::move(frame)), opcode);
+        return;
+    }
+
+    // 大帧以帧头、载荷两段 writev：队列空闲时直接从调用方内存写出，未写完的部分才拷贝进队列
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = header_len;
+    iov[1].iov_base = const_cast<char*>(data);
+    iov[1].iov_len = len;
+    TcpConnection::Send(iov, 2);
+}
+
+void WebSocketConnection::SendFrame(SendItem&& payload, WebSocketOpcode opcode) {
+    if (SendCompressed(payload.Data(), payload.Size(), opcode)) {
+        return;
+    }
+
+    size_t fragment_size = GetWebSocketServer()->fragment_size_;
+    if (fragment_size > 0 && payload.Size() > fragment_size) {
+        QueueMessage(std::make_shared<SendItem>(std::move(payload)), opcode, 0);
+        return;
+    }
+
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, true, opcode, payload.Size());
+
+    // 帧头不超过14字节，放在 std::string 的内联存储中，不分配内存
+    QueueFrame(SendItem(header, header_len), std::move(payload));
+}
+
+void WebSocketConnection::SendFrame(SendBuffer&& buffer, WebSocketOpcode opcode, uint8_t rsv) {
+    if (rsv == 0 && SendCompressed(buffer.Data(), buffer.Size(), opcode)) {
+        return;
+    }
+
+    size_t fragment_size = GetWebSocketServer()->fragment_size_;
+    if (fragment_size > 0 && buffer.Size() > fragment_size) {
+        // 预留的帧头空间不再使用，各片的帧头在发送时生成
+        QueueMessage(std::make_shared<SendItem>(buffer.Release()), opcode, rsv);
+        return;
+    }
+
+    char header[kWebSocketMaxHeaderSize];
+    size_t header_len = EncodeWebSocketFrameHeader(header, true, opcode, buffer.Size(), rsv);
+
+    // 帧头写入载荷前预留的空间，整帧是一块连续内存
+    memcpy(buffer.Prepend(header_len), header, header_len);
+    QueueFrame(SendItem(buffer.Release()), opcode);
+}
+
+bool WebSocketConnection::SendCompressed(const char* data, size_t len, WebSocketOpcode opcode) {
+    if (!deflate_ || !deflate_->ShouldCompress(len)) {
+        return false;
+    }
+    // 压缩结果写入预留了帧头空间的缓冲区，按压缩上界一次分配
+    SendBuffer buffer(kWebSocketMaxHeaderSize, WebSocketDeflate::CompressBound(len));
+    if (!deflate_->Compress(data, len, buffer)) {
+        PLOG_ERROR << "WebSocket Connection " << conn_id_ << " deflate failed, sending uncompressed";
+        return false;
+    }
+    // 不保留上下文时压缩器不记录历史，压缩无收益的消息可以改为原样发送
+    if (buffer.Size() >= len && deflate_->Params().server_no_context_takeover) {
+        return false;
+    }
+    SendFrame(std::move(buffer), opcode, kWebSocketRsv1);
+    return true;
+}
+
+void WebSocketConnection::QueueFrame(SendItem&& item, WebSocketOpcode opcode) {
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (GetWebSocketServer()->fragment_size_ == 0) {
+            send_queue_.push(std::move(item));
+        } else if (IsControlOpcode(opcode)) {
+            // 发出关闭帧后不能再发送数据帧，尚未移入发送队列的数据丢弃
+            if (opcode == WebSocketOpcode::CLOSE) {
+                outbound_.clear();
+            }
+            control_queue_.push(std::move(item));
+        } else {
+            outbound_.emplace_back(std::move(item), SendItem());
+        }
     }
     
     // 触发发送尝试
     TrySend();
 }
 
-void WebSocketConnection::TrySend() {
-    std::string data_to_send;
-    {    std::lock_guard<std::mutex> lock(send_mutex_);
-        // 如果正在发送，或者队列为空，直接返回
-        if (is_writing_ || send_queue_.empty()) {
-            return;
+void WebSocketConnection::QueueFrame(SendItem&& header, SendItem&& payload) {
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (GetWebSocketServer()->fragment_size_ == 0) {
+            send_queue_.push(std::move(header));
+            send_queue_.push(std::move(payload));
+        } else {
+            outbound_.emplace_back(std::move(header), std::move(payload));
         }
-        
-        // 取出队首数据
-        data_to_send = std::move(send_queue_.front());
-        send_queue_.pop();
-        
-        // 标记正在发送
-        is_writing_ = true;
     }
     
-    // 准备 libuv 写请求
-    WriteReq* req = new WriteReq();
-    // 将数据移动到 req 中，保证异步回调期间数据有效
-    req->data = std::move(data_to_send);
-    req->req.data = this;
-    
-    uv_buf_t buf = uv_buf_init(const_cast<char*>(req->data.c_str()), req->data.size());
-    
-    int r = uv_write(&req->req, (uv_stream_t*)&handle_, &buf, 1, 
-        [](uv_write_t* uv_req, int status) {
-            // 使用 reinterpret_cast 而不是 static_cast
-            WriteReq* wr = reinterpret_cast<WriteReq*>(uv_req);
-            WebSocketConnection* conn = static_cast<WebSocketConnection*>(wr->req.data);
-            
-            // 1. 释放请求内存（连带释放 string buffer）
-            delete wr;
-            
-            // 2. 处理回调状态
-            conn->OnWriteComplete(status);
-        }
-    );
-    
-    if (r != 0) {
-        std::cerr << "Send error: " << uv_strerror(r) << std::endl;
-        delete req; // 回调没触发，手动删
-        is_writing_ = false; // 恢复状态
-        // 错误发生，关闭连接
-        Close();
+    // 触发发送尝试，两个元素在同一次 writev 中发出
+    TrySend();
+}
+
+void WebSocketConnection::QueueMessage(std::shared_ptr<SendItem> payload, WebSocketOpcode opcode, uint8_t rsv) {
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        outbound_.emplace_back(std::move(payload), opcode, rsv);
     }
+    TrySend();
 }
 
-void WebSocketConnection::ParseFrame(const char* data, size_t len) {
-    PLOG_INFO << "WebSocket Connection parsing frame of " << len << " bytes";
-    const char* ptr = data;
-    const char* end = data + len;
-    
-    while (ptr < end) {
-        switch (parse_state_) {
-            case ParseState::READ_HEADER: {
-                if (bytes_read_ < 2) {
-                    buffer_.insert(buffer_.end(), ptr, end);
-                    bytes_read_ += (end - ptr);
-                    ptr = end;
-                    
-                    if (bytes_read_ >= 2) {
-                        // 解析头部
-                        uint8_t first_byte = static_cast<uint8_t>(buffer_[0]);
-                        uint8_t second_byte = static_cast<uint8_t>(buffer_[1]);
-                        
-                        current_frame_.fin = (first_byte & 0x80) != 0;
-                        current_frame_.opcode = first_byte & 0x0F;
-                        current_frame_.masked = (second_byte & 0x80) != 0;
-                        
-                        uint8_t payload_len = second_byte & 0x7F;
-                        if (payload_len < 126) {
-                            current_frame_.payload_length = payload_len;
-                            parse_state_ = ParseState::READ_MASKING_KEY;
-                        } else if (payload_len == 126) {
-                            current_frame_.payload_length = 0;
-                            parse_state_ = ParseState::READ_PAYLOAD_LENGTH;
-                        } else {
-                            current_frame_.payload_length = 0;
-                            parse_state_ = ParseState::READ_PAYLOAD_LENGTH;
-                        }
-                        
-                        // 移除已处理的头部数据
-                        buffer_.erase(buffer_.begin(), buffer_.begin() + 2);
-                        bytes_read_ -= 2;
-                    }
-                }
-                break;
+void WebSocketConnection::TrySend() {
+    // 发送队列只保留下一次写出的内容，控制帧因此最多等待一个分片
+    if (!is_writing_ && cork_depth_ == 0 && send_queue_.empty() && HasQueuedFrames()) {
+        StageFrames();
+    }
+    TcpConnection::TrySend();
+}
+
+void WebSocketConnection::StageFrames() {
+    size_t fragment_size = GetWebSocketServer()->fragment_size_;
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    while (!control_queue_.empty()) {
+        send_queue_.push(std::move(control_queue_.front()));
+        control_queue_.pop();
+    }
+
+    // 数据帧按序移入，合计不超过一个分片（至少一帧），小帧仍在同一次 writev 中合并
+    size_t staged = 0;
+    while (!outbound_.empty() && staged < fragment_size && send_queue_.size() + 2 <= kMaxWriteBufs) {
+        OutboundMessage& msg = outbound_.front();
+        if (!msg.source) {
+            staged += msg.head.Size() + msg.body.Size();
+            send_queue_.push(std::move(msg.head));
+            if (msg.body.Size() > 0) {
+                send_queue_.push(std::move(msg.body));
             }
-            case ParseState::READ_PAYLOAD_LENGTH: {
-                size_t needed = (current_frame_.payload_length == 0) ? 2 : 8;
-                if (bytes_read_ < needed) {
-                    buffer_.insert(buffer_.end(), ptr, end);
-                    bytes_read_ += (end - ptr);
-                    ptr = end;
-                    
-                    if (bytes_read_ >= needed) {
-                        if (needed == 2) {
-                            uint16_t len16 = 0;
-                            memcpy(&len16, buffer_.data(), 2);
-                            current_frame_.payload_length = ntohs(len16);
-                        } else {
-                            uint64_t len64 = 0;
-                            memcpy(&len64, buffer_.data(), 8);
-                            current_frame_.payload_length = be64toh(len64);
-                        }
-                        
-                        buffer_.erase(buffer_.begin(), buffer_.begin() + needed);
-                        bytes_read_ -= needed;
-                        parse_state_ = ParseState::READ_MASKING_KEY;
-                    }
-                }
-                break;
+            outbound_.pop_front();
+            continue;
+        }
+
+        size_t total = msg.source->Size();
+        size_t n = std::min(fragment_size, total - msg.offset);
+        bool first = msg.offset == 0;
+        bool fin = msg.offset + n == total;
+        char header[kWebSocketMaxHeaderSize];
+        size_t header_len = EncodeWebSocketFrameHeader(header, fin, first ? msg.opcode : WebSocketOpcode::CONTINUATION,
+                                                       n, first ? msg.rsv : 0);
+        send_queue_.push(SendItem(header, header_len));
+        // 分片直接引用原载荷，每片持有一份 source 的引用，写完后释放
+        std::shared_ptr<SendItem> source = msg.source;
+        send_queue_.push(SendItem(Buffer(const_cast<char*>(source->Data()) + msg.offset, n,
+                                         [source](char*, size_t) {})));
+        msg.offset += n;
+        staged += header_len + n;
+        if (fin) {
+            outbound_.pop_front();
+        }
+    }
+}
+
+size_t WebSocketConnection::ParseFrames(char* data, size_t len) {
+    size_t max_package_size = server_->GetConfig().GetMaxPackageSize();
+    size_t pos = 0;
+    recv_need_ = 0;
+
+    // 逐帧移动游标，一次读取中的多个帧全部在原缓冲区内处理
+    while (pos < len && state_ == State::OPEN && !is_closing_gracefully_) {
+        if (stream_remaining_ > 0) {
+            pos += StreamPayload(data + pos, len - pos);
+            continue;
+        }
+
+        WebSocketFrame frame;
+        int header_len = ParseWebSocketFrameHeader(data + pos, len - pos, frame);
+        if (header_len == 0) {
+            break;
+        }
+        // 客户端发出的帧必须带掩码；RSV 只允许协商了 permessage-deflate 时消息首帧的 RSV1
+        bool compressed = frame.rsv == kWebSocketRsv1 && deflate_ && !IsControlOpcode(frame.opcode) &&
+                          frame.opcode != WebSocketOpcode::CONTINUATION;
+        if (header_len < 0 || !frame.masked || (frame.rsv != 0 && !compressed)) {
+            PLOG_ERROR << "WebSocket Connection " << conn_id_ << " protocol error, closing connection";
+            FailConnection(1002);
+            return len;
+        }
+
+        if (!IsControlOpcode(frame.opcode)) {
+            // 后续帧只能出现在分片消息中，分片消息结束前不能开始新消息（控制帧可以穿插）
+            if ((frame.opcode == WebSocketOpcode::CONTINUATION) != in_message_) {
+                PLOG_ERROR << "WebSocket Connection " << conn_id_ << " unexpected fragment, closing connection";
+                FailConnection(1002);
+                return len;
             }
-            case ParseState::READ_MASKING_KEY: {
-                if (current_frame_.masked) {
-                    if (bytes_read_ < 4) {
-                        buffer_.insert(buffer_.end(), ptr, end);
-                        bytes_read_ += (end - ptr);
-                        ptr = end;
-                        
-                        if (bytes_read_ >= 4) {
-                            memcpy(current_frame_.masking_key, buffer_.data(), 4);
-                            buffer_.erase(buffer_.begin(), buffer_.begin() + 4);
-                            bytes_read_ -= 4;
-                            parse_state_ = ParseState::READ_PAYLOAD;
-                        }
-                    }
-                } else {
-                    parse_state_ = ParseState::READ_PAYLOAD;
-                }
-                break;
+            if (ShouldStream(frame)) {
+                pos += static_cast<size_t>(header_len);
+                BeginStreamFrame(frame);
+                continue;
             }
-            case ParseState::READ_PAYLOAD: {
-                size_t needed = current_frame_.payload_length - buffer_.size();
-                size_t available = end - ptr;
-                size_t to_read = std::min(needed, available);
-                
-                buffer_.insert(buffer_.end(), ptr, ptr + to_read);
-                ptr += to_read;
-                
-                if (buffer_.size() >= current_frame_.payload_length) {
-                    // 完整帧已接收
-                    if (current_frame_.masked) {
-                        // 解除掩码
-                        for (size_t i = 0; i < buffer_.size(); ++i) {
-                            buffer_[i] ^= current_frame_.masking_key[i % 4];
-                        }
-                    }
-                    
-                    // 处理帧
-                    switch (current_frame_.opcode) {
-                        case 0x01: // 文本帧
-                            PLOG_INFO << "WebSocket Connection received text frame of " << buffer_.size() << " bytes";
-                            ProcessTextFrame(buffer_.data(), buffer_.size());
-                            break;
-                        case 0x02: // 二进制帧
-                            PLOG_INFO << "WebSocket Connection received binary frame of " << buffer_.size() << " bytes";
-                            ProcessBinaryFrame(buffer_.data(), buffer_.size());
-                            break;
-                        case 0x08: // 关闭帧
-                            PLOG_INFO << "WebSocket Connection received close frame";
-                            ProcessCloseFrame(buffer_.data(), buffer_.size());
-                            break;
-                        case 0x09: // Ping帧
-                            PLOG_INFO << "WebSocket Connection received ping frame";
-                            ProcessPingFrame(buffer_.data(), buffer_.size());
-                            break;
-                        case 0x0A: // Pong帧
-                            PLOG_INFO << "WebSocket Connection received pong frame";
-                            ProcessPongFrame(buffer_.data(), buffer_.size());
-                            break;
-                    }
-                    
-                    // 重置状态，准备下一个帧
-                    buffer_.clear();
-                    bytes_read_ = 0;
-                    parse_state_ = ParseState::READ_HEADER;
-                    memset(&current_frame_, 0, sizeof(current_frame_));
-                }
-                break;
+            if (message_size_ + frame.payload_length > max_package_size) {
+                PLOG_ERROR << "WebSocket Connection " << conn_id_ << " message of " << message_size_ + frame.payload_length
+                           << " bytes exceeds max package size, closing connection";
+                FailConnection(1009);
+                return len;
             }
         }
+
+        size_t frame_len = static_cast<size_t>(header_len) + static_cast<size_t>(frame.payload_length);
+        if (len - pos < frame_len) {
+            recv_need_ = frame_len;
+            break;
+        }
+
+        frame.payload = data + pos + header_len;
+        MaskBytes(frame.payload, static_cast<size_t>(frame.payload_length), frame.masking_key);
+        pos += frame_len;
+        OnFrame(frame);
+    }
+    return pos;
+}
+
+WebSocketServer* WebSocketConnection::GetWebSocketServer() const {
+    return static_cast<WebSocketServer*>(server_);
+}
+
+void WebSocketConnection::OnFrame(const WebSocketFrame& frame) {
+    size_t len = static_cast<size_t>(frame.payload_length);
+    switch (frame.opcode) {
+        case WebSocketOpcode::CONTINUATION:
+        case WebSocketOpcode::TEXT:
+        case WebSocketOpcode::BINARY:
+            OnDataFrame(frame);
+            break;
+        case WebSocketOpcode::CLOSE:
+            PLOG_INFO << "WebSocket Connection received close frame";
+            ProcessCloseFrame(frame.payload, len);
+            break;
+        case WebSocketOpcode::PING:
+            PLOG_DEBUG << "WebSocket Connection received ping frame";
+            ProcessPingFrame(frame.payload, len);
+            break;
+        case WebSocketOpcode::PONG:
+            PLOG_DEBUG << "WebSocket Connection received pong frame";
+            ProcessPongFrame(frame.payload, len);
+            break;
+    }
+}
+
+void WebSocketConnection::OnDataFrame(const WebSocketFrame& frame) {
+    size_t len = static_cast<size_t>(frame.payload_length);
+    if (!in_message_ && frame.fin && frame.rsv == 0) {
+        // 未分片的消息：载荷已在接收缓冲区中解掩码，文本校验 UTF-8 后直接交付
+        if (frame.opcode == WebSocketOpcode::TEXT && !ValidateUtf8(frame.payload, len)) {
+            FailInvalidUtf8();
+            return;
+        }
+        DeliverMessage(frame.opcode, frame.payload, len);
+        return;
+    }
+
+    if (!in_message_) {
+        in_message_ = true;
+        message_opcode_ = frame.opcode;
+        message_compressed_ = frame.rsv != 0;
+        message_buffer_ = GetWebSocketServer()->AcquireMessageBuffer();
+    }
+    // 文本消息逐帧校验新增的数据（压缩消息校验解压结果），跨帧的不完整字符由 utf8_ 暂存
+    size_t validated = message_buffer_.size();
+    if (message_compressed_) {
+        // 压缩消息逐帧解压到重组缓冲区，解压后的长度同样受最大包大小限制
+        WebSocketDeflate::Result result = deflate_->Decompress(frame.payload, len, frame.fin, message_buffer_,
+                                                               server_->GetConfig().GetMaxPackageSize());
+        if (result != WebSocketDeflate::kOk) {
+            PLOG_ERROR << "WebSocket Connection " << conn_id_ << (result == WebSocketDeflate::kTooLarge ?
+                       " inflated message exceeds max package size" : " inflate failed") << ", closing connection";
+            FailConnection(result == WebSocketDeflate::kTooLarge ? 1009 : 1007);
+            return;
+        }
+    } else {
+        message_buffer_.insert(message_buffer_.end(), frame.payload, frame.payload + len);
+    }
+    message_size_ += len;
+    if (message_opcode_ == WebSocketOpcode::TEXT &&
+        (!utf8_.Update(message_buffer_.data() + validated, message_buffer_.size() - validated) ||
+         (frame.fin && !utf8_.Finish()))) {
+        FailInvalidUtf8();
+        return;
+    }
+
+    if (frame.fin) {
+        DeliverMessage(message_opcode_, message_buffer_.data(), message_buffer_.size());
+        ResetMessage();
+    }
+}
+
+void WebSocketConnection::DeliverMessage(WebSocketOpcode opcode, const char* data, size_t len) {
+    if (opcode == WebSocketOpcode::BINARY) {
+        PLOG_DEBUG << "WebSocket Connection received binary message of " << len << " bytes";
+        ProcessBinaryFrame(data, len);
+    } else {
+        PLOG_DEBUG << "WebSocket Connection received text message of " << len << " bytes";
+        ProcessTextFrame(data, len);
+    }
+}
+
+bool WebSocketConnection::ShouldStream(const WebSocketFrame& frame) const {
+    WebSocketServer* server = GetWebSocketServer();
+    // 压缩消息需要完整解压，不流式交付
+    if (!server->IsStreamingEnabled() || message_compressed_ || frame.rsv != 0) {
+        return false;
+    }
+    return message_streaming_ || message_size_ + frame.payload_length > server->chunk_threshold_;
+}
+
+void WebSocketConnection::BeginStreamFrame(const WebSocketFrame& frame) {
+    if (!in_message_) {
+        in_message_ = true;
+        message_opcode_ = frame.opcode;
+    }
+    if (!message_streaming_) {
+        // 转为流式交付：已重组的部分作为第一段
+        message_streaming_ = true;
+        chunk_first_ = true;
+        if (!message_buffer_.empty()) {
+            DeliverChunk(message_buffer_.data(), message_buffer_.size(), false);
+        }
+        GetWebSocketServer()->ReleaseMessageBuffer(std::move(message_buffer_));
+        message_buffer_ = std::vector<char>();
+    }
+
+    stream_frame_ = frame;
+    stream_remaining_ = frame.payload_length;
+    stream_offset_ = 0;
+    if (stream_remaining_ == 0 && frame.fin) {
+        if (message_opcode_ == WebSocketOpcode::TEXT && !utf8_.Finish()) {
+            FailInvalidUtf8();
+            return;
+        }
+        DeliverChunk(nullptr, 0, true);
+        ResetMessage();
+    }
+}
+
+size_t WebSocketConnection::StreamPayload(char* data, size_t len) {
+    size_t n = stream_remaining_ < len ? static_cast<size_t>(stream_remaining_) : len;
+    MaskBytes(data, n, stream_frame_.masking_key, static_cast<size_t>(stream_offset_ & 3));
+    stream_offset_ += n;
+    stream_remaining_ -= n;
+    message_size_ += n;
+
+    bool last = stream_remaining_ == 0 && stream_frame_.fin;
+    if (message_opcode_ == WebSocketOpcode::TEXT && (!utf8_.Update(data, n) || (last && !utf8_.Finish()))) {
+        FailInvalidUtf8();
+        return len;
+    }
+    DeliverChunk(data, n, last);
+    if (last) {
+        ResetMessage();
+    }
+    return n;
+}
+
+void WebSocketConnection::DeliverChunk(const char* data, size_t len, bool last) {
+    bool first = chunk_first_;
+    chunk_first_ = false;
+    std::shared_ptr<WebSocketConnection> shared_conn(this, [](WebSocketConnection*){});
+    GetWebSocketServer()->OnMessageChunk(shared_conn, data, len, first, last);
+}
+
+void WebSocketConnection::ResetMessage() {
+    in_message_ = false;
+    message_streaming_ = false;
+    message_compressed_ = false;
+    message_size_ = 0;
+    utf8_.Reset();
+    if (message_buffer_.capacity() > 0) {
+        GetWebSocketServer()->ReleaseMessageBuffer(std::move(message_buffer_));
+        message_buffer_ = std::vector<char>();
+    }
+}
+
+void WebSocketConnection::FailInvalidUtf8() {
+    PLOG_ERROR << "WebSocket Connection " << conn_id_ << " invalid UTF-8 in text message, closing connection";
+    FailConnection(1007);
+}
+
+void WebSocketConnection::FailConnection(uint16_t code) {
+    uint16_t net_code = htons(code);
+    SendFrame(reinterpret_cast<const char*>(&net_code), 2, WebSocketOpcode::CLOSE);
+    Close();
+}
+
+void WebSocketConnection::ParsePending() {
+    size_t avail = recv_buffer_.size() - recv_offset_;
+    if (avail == 0 || avail < recv_need_) {
+        return;
+    }
+    recv_offset_ += ParseFrames(recv_buffer_.data() + recv_offset_, avail);
+
+    if (recv_offset_ == recv_buffer_.size()) {
+        recv_buffer_.clear();
+        recv_offset_ = 0;
+    } else if (recv_offset_ > recv_buffer_.size() / 2) {
+        // 已处理部分超过一半时才压缩
+        recv_buffer_.erase(recv_buffer_.begin(), recv_buffer_.begin() + recv_offset_);
+        recv_offset_ = 0;
+    }
+    // 为未完成的大帧一次性预留空间
+    if (recv_need_ > recv_buffer_.size() - recv_offset_) {
+        recv_buffer_.reserve(recv_offset_ + recv_need_);
     }
 }
 
@@ -428,46 +631,150 @@ void WebSocketConnection::ProcessBinaryFrame(const char* data, size_t len) {
 }
 
 void WebSocketConnection::ProcessCloseFrame(const char* data, size_t len) {
-    state_ = State::CLOSING;
-    // 发送关闭响应
-    SendFrame(data, len, 0x08);
+    // 回复关闭帧后关闭（Close 会将状态置为 CLOSING）
+    SendFrame(data, len, WebSocketOpcode::CLOSE);
     Close();
 }
 
 void WebSocketConnection::ProcessPingFrame(const char* data, size_t len) {
     // 回复 Pong 帧
-    SendFrame(data, len, 0x0A);
+    SendFrame(data, len, WebSocketOpcode::PONG);
 }
 
 void WebSocketConnection::ProcessPongFrame(const char* data, size_t len) {
-    // 忽略 Pong 帧
+    // 只有回送最近一次 Ping 时间戳的 Pong 计入 RTT 和存活，其他 Pong（RFC 6455 允许单向发送）忽略
+    uint64_t sent_ns;
+    if (len != sizeof(sent_ns) || ping_sent_ns_ == 0) {
+        return;
+    }
+    memcpy(&sent_ns, data, sizeof(sent_ns));
+    if (sent_ns != ping_sent_ns_) {
+        return;
+    }
+    ping_sent_ns_ = 0;
+    missed_pongs_ = 0;
+    OnRttSample(static_cast<int64_t>((uv_hrtime() - sent_ns) / 1000));
+}
+
+void WebSocketConnection::SendPing() {
+    // 时间戳只由本端解释，按本机字节序写入
+    uint64_t now = uv_hrtime();
+    SendFrame(reinterpret_cast<const char*>(&now), sizeof(now), WebSocketOpcode::PING);
+    ping_sent_ns_ = now;
+}
+
+void WebSocketConnection::OnRttSample(int64_t rtt_us) {
+    rtt_.last_us = rtt_us;
+    rtt_.ewma_us = rtt_.samples == 0 ? rtt_us : rtt_.ewma_us + (rtt_us - rtt_.ewma_us) / 8;
+    rtt_.max_us = rtt_us > rtt_.max_us ? rtt_us : rtt_.max_us;
+    rtt_.samples++;
+    GetWebSocketServer()->rtt_histogram_.Record(rtt_us);
+    PLOG_DEBUG << "WebSocket Connection " << conn_id_ << " rtt " << rtt_us << "us, ewma " << rtt_.ewma_us << "us";
 }
 
 // WebSocketConnection 其他方法
-void WebSocketConnection::Send(const char* data, size_t len) {
+bool WebSocketConnection::CanSend() {
     if (state_ != State::OPEN || is_closing_gracefully_) {
         PLOG_INFO << "WebSocket Connection not open or closing, dropping send request";
-        return;
+        return false;
     }
     
     // 检查发送队列大小是否超过配置的最大值
-    {
-        std::lock_guard<std::mutex> lock(send_mutex_);
-        if (send_queue_.size() >= server_->GetConfig().GetMaxSendQueueSize()) {
-            PLOG_WARNING << "WebSocket Connection send queue full, dropping send request";
-            return;
-        }
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    if (send_queue_.size() + outbound_.size() >= server_->GetConfig().GetMaxSendQueueSize()) {
+        PLOG_WARNING << "WebSocket Connection send queue full, dropping send request";
+        return false;
+    }
+    return true;
+}
+
+void WebSocketConnection::Send(const char* data, size_t len) {
+    if (!CanSend()) {
+        return;
     }
     
     PLOG_INFO << "WebSocket Connection sending message of " << len << " bytes";
-    SendFrame(data, len, 0x01); // 默认发送文本帧
+    SendFrame(data, len, WebSocketOpcode::TEXT); // 默认发送文本帧
+}
+
+void WebSocketConnection::Send(std::string&& data) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending message of " << data.size() << " bytes";
+    SendFrame(SendItem(std::move(data)), WebSocketOpcode::TEXT);
+}
+
+void WebSocketConnection::Send(Buffer&& buffer) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending message of " << buffer.Size() << " bytes";
+    SendFrame(SendItem(std::move(buffer)), WebSocketOpcode::TEXT);
+}
+
+SendBuffer WebSocketConnection::NewSendBuffer(size_t capacity) {
+    return SendBuffer(kWebSocketMaxHeaderSize, capacity);
+}
+
+void WebSocketConnection::SendPackage(SendBuffer&& buffer) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending message of " << buffer.Size() << " bytes";
+    SendFrame(std::move(buffer), WebSocketOpcode::TEXT);
+}
+
+void WebSocketConnection::SendBinary(const char* data, size_t len) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending binary message of " << len << " bytes";
+    SendFrame(data, len, WebSocketOpcode::BINARY);
+}
+
+void WebSocketConnection::SendBinary(Buffer&& buffer) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending binary message of " << buffer.Size() << " bytes";
+    SendFrame(SendItem(std::move(buffer)), WebSocketOpcode::BINARY);
+}
+
+void WebSocketConnection::SendBinary(SendBuffer&& buffer) {
+    if (!CanSend()) {
+        return;
+    }
+    
+    PLOG_INFO << "WebSocket Connection sending binary message of " << buffer.Size() << " bytes";
+    SendFrame(std::move(buffer), WebSocketOpcode::BINARY);
+}
+
+void WebSocketConnection::SendPrepared(const PreparedFrame& frame) {
+    if (frame.Empty() || !CanSend()) {
+        return;
+    }
+    
+    // 预压缩的帧不经过本连接的压缩器，之后的消息不能再引用压缩器中的历史
+    bool compressed = deflate_ && frame.HasCompressed() &&
+                      deflate_->Params().server_max_window_bits >= frame.CompressedWindowBits();
+    if (compressed) {
+        deflate_->ResetCompressor();
+    }
+    PLOG_DEBUG << "WebSocket Connection sending prepared frame of " << (compressed ? frame.CompressedSize() : frame.Size()) << " bytes";
+    QueueFrame(SendItem(frame.ToBuffer(compressed)), frame.Opcode());
 }
 
 void WebSocketConnection::OnWriteComplete(int status) {
     if (status < 0) {
         if (status != UV_ECANCELED) {
             PLOG_ERROR << "WebSocket Connection write failed: " << uv_strerror(status);
-            Close();
+            CloseImmediately();
         }
         return;
     }
@@ -480,11 +787,13 @@ void WebSocketConnection::OnWriteComplete(int status) {
     // 尝试发送队列中的下一包数据
     TrySend();
     
-    // 检查是否需要优雅关闭
+    // 检查是否需要优雅关闭（零拷贝缓冲区需等待内核完成通知，由 DrainZeroCopyCompletions 再次触发）
     {
         std::lock_guard<std::mutex> lock(send_mutex_);
-        if (is_closing_gracefully_ && send_queue_.empty() && !is_writing_) {
+        if (is_closing_gracefully_ && !is_closing_ && IsSendIdle() && !HasQueuedFrames()) {
             PLOG_INFO << "WebSocket Connection send queue empty, closing gracefully";
+            is_closing_ = true;
+            ReleaseSendResources();
             // 发送队列已空，执行实际关闭
             uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
                 WebSocketConnection* conn = static_cast<WebSocketConnection*>(handle->data);
@@ -498,7 +807,7 @@ void WebSocketConnection::OnWriteComplete(int status) {
                     std::shared_ptr<WebSocketConnection> shared_conn(conn, [](WebSocketConnection*){});
                     conn->server_->OnClose(shared_conn);
                 }
-                delete conn; // 最终释放 Connection 对象
+                conn->DestroyLater(); // 心跳定时器关闭后释放 Connection 对象
             });
         }
     }
@@ -516,38 +825,44 @@ void WebSocketConnection::Close() {
     bool is_empty = false;
     {
         std::lock_guard<std::mutex> lock(send_mutex_);
-        is_empty = send_queue_.empty();
+        is_empty = IsSendIdle() && !HasQueuedFrames();
     }
     
-    if (is_empty && !is_writing_) {
+    if (is_empty) {
         // 发送队列为空，直接关闭
-        state_ = State::CLOSING;
-        PLOG_INFO << "WebSocket Connection closing immediately";
-        
-        // 关闭 handle，触发 close 回调
-        uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
-            WebSocketConnection* conn = static_cast<WebSocketConnection*>(handle->data);
-            conn->state_ = State::CLOSED;
-            // 计算在线时长（秒）
-            size_t now = uv_now(uv_default_loop());
-            double online_seconds = (now - conn->create_time_) / 1000.0;
-            PLOG_INFO << "WebSocket Connection " << conn->conn_id_ << " closed immediately, online time: " << online_seconds << " seconds";
-            // 触发用户层的 OnClose
-            if (conn->server_) {
-                std::shared_ptr<WebSocketConnection> shared_conn(conn, [](WebSocketConnection*){});
-                conn->server_->OnClose(shared_conn);
-            }
-            delete conn; // 最终释放 Connection 对象
-        });
+        CloseImmediately();
     } else {
         // 发送队列不为空，执行优雅关闭
         is_closing_gracefully_ = true;
         state_ = State::CLOSING;
         PLOG_INFO << "WebSocket Connection closing gracefully";
         // 不立即关闭，等待发送队列处理完毕
+        cork_depth_ = 0;
+        TrySend();
     }
 }
 
+void WebSocketConnection::CloseHandle() {
+    state_ = State::CLOSING;
+    ReleaseSendResources();
+
+    // 关闭 handle，触发 close 回调
+    uv_close((uv_handle_t*)&handle_, [](uv_handle_t* handle) {
+        WebSocketConnection* conn = static_cast<WebSocketConnection*>(handle->data);
+        conn->state_ = State::CLOSED;
+        // 计算在线时长（秒）
+        size_t now = uv_now(uv_default_loop());
+        double online_seconds = (now - conn->create_time_) / 1000.0;
+        PLOG_INFO << "WebSocket Connection " << conn->conn_id_ << " closed immediately, online time: " << online_seconds << " seconds";
+        // 触发用户层的 OnClose
+        if (conn->server_) {
+            std::shared_ptr<WebSocketConnection> shared_conn(conn, [](WebSocketConnection*){});
+            conn->server_->OnClose(shared_conn);
+        }
+        conn->DestroyLater(); // 心跳定时器关闭后释放 Connection 对象
+    });
+}
+
 void WebSocketConnection::StartHeartbeat() {
     if (is_heartbeat_running_) {
         return;
@@ -556,6 +871,17 @@ void WebSocketConnection::StartHeartbeat() {
     is_heartbeat_running_ = true;
     last_active_time_ = uv_now(uv_default_loop());
     
+    // 握手阶段只启动一次性的握手超时，握手完成后重新启动为心跳
+    int64_t handshake_timeout = GetWebSocketServer()->handshake_timeout_;
+    if (state_ == State::HANDSHAKE && handshake_timeout > 0) {
+        uv_timer_start(&heartbeat_timer_, [](uv_timer_t* timer) {
+            WebSocketConnection* conn = static_cast<WebSocketConnection*>(timer->data);
+            conn->OnHeartbeatTimeout();
+        }, handshake_timeout, 0);
+        PLOG_INFO << "WebSocket Connection handshake timer started, timeout: " << handshake_timeout << "ms";
+        return;
+    }
+    
     // 启动心跳定时器，间隔为配置的心跳间隔
     uv_timer_start(&heartbeat_timer_, [](uv_timer_t* timer) {
         WebSocketConnection* conn = static_cast<WebSocketConnection*>(timer->data);
@@ -576,6 +902,32 @@ void WebSocketConnection::StopHeartbeat() {
 }
 
 void WebSocketConnection::OnHeartbeatTimeout() {
+    // 对端断开时读回调已关闭句柄，不能再次关闭
+    if (uv_is_closing((uv_handle_t*)&handle_)) {
+        StopHeartbeat();
+        return;
+    }
+
+    if (state_ == State::HANDSHAKE) {
+        PLOG_WARNING << "WebSocket Connection " << conn_id_ << " handshake timeout, closing connection";
+        Close();
+        return;
+    }
+
+    WebSocketServer* server = GetWebSocketServer();
+    if (server->ping_enabled_) {
+        // 上一次心跳的 Ping 在一个间隔内没有收到 Pong
+        if (ping_sent_ns_ != 0 && ++missed_pongs_ >= server->max_missed_pongs_) {
+            PLOG_WARNING << "WebSocket Connection " << conn_id_ << " missed " << missed_pongs_ << " pongs, closing connection";
+            Close();
+            return;
+        }
+        if (state_ == State::OPEN && !is_closing_gracefully_) {
+            SendPing();
+        }
+        return;
+    }
+
     size_t now = uv_now(uv_default_loop());
     size_t interval = server_->GetConfig().GetHeartbeatInterval();
     
@@ -588,22 +940,66 @@ void WebSocketConnection::OnHeartbeatTimeout() {
 }
 
 void WebSocketConnection::OnDataReceived(const char* data, size_t len) {
-    PLOG_INFO << "WebSocket Connection received data of " << len << " bytes, state: " << static_cast<int>(state_);
+    PLOG_DEBUG << "WebSocket Connection received data of " << len << " bytes, state: " << static_cast<int>(state_);
+    last_active_time_ = uv_now(uv_default_loop());
     
     if (state_ == State::HANDSHAKE) {
-        // 处理握手数据
-        handshake_buffer_.insert(handshake_buffer_.end(), data, data + len);
-        
-        // 检查是否接收到完整的握手请求
-        if (std::search(handshake_buffer_.begin(), handshake_buffer_.end(), "\r\n\r\n", "\r\n\r\n" + 4) != handshake_buffer_.end()) {
-            // 将 vector<char> 转换为 string 传递给 ParseHandshake
-            std::string handshake_str(handshake_buffer_.begin(), handshake_buffer_.end());
-            ParseHandshake(handshake_str);
+        if (handshake_responded_) {
+            // 握手响应尚未写完时到达的帧，等 OnHandshakeComplete 后再解析
+            recv_buffer_.insert(recv_buffer_.end(), data, data + len);
+            return;
         }
-    } else {
-        // 处理 WebSocket 帧
-        ParseFrame(data, len);
+
+        // 请求头通常在一次读取中完整到达，此时直接在读缓冲区上解析，不拷贝
+        const char* head = data;
+        size_t avail = len;
+        if (!handshake_buffer_.empty()) {
+            handshake_buffer_.insert(handshake_buffer_.end(), data, data + len);
+            head = handshake_buffer_.data();
+            avail = handshake_buffer_.size();
+        }
+
+        // 从上次扫描位置之前两个字节继续，避免漏掉跨读取边界的空行
+        size_t from = handshake_scanned_ > 2 ? handshake_scanned_ - 2 : 0;
+        size_t head_len = HttpParser::FindHeadEnd(head, avail, from);
+        if (head_len == 0 || head_len > kWebSocketMaxHandshakeSize) {
+            if (head_len > kWebSocketMaxHandshakeSize || avail > kWebSocketMaxHandshakeSize) {
+                PLOG_ERROR << "WebSocket Connection " << conn_id_ << " handshake failed: request header too large";
+                RejectHandshake(431);
+                return;
+            }
+            if (handshake_buffer_.empty()) {
+                handshake_buffer_.assign(data, data + len);
+            }
+            handshake_scanned_ = avail;
+            return;
+        }
+
+        // 与握手请求一起到达的帧留给帧解析
+        recv_buffer_.assign(head + head_len, head + avail);
+        recv_offset_ = 0;
+        handshake_responded_ = ParseHandshake(head, head_len);
+        std::vector<char>().swap(handshake_buffer_);
+        return;
     }
+
+    if (recv_offset_ == recv_buffer_.size()) {
+        // 没有残留数据：直接在本次读取的缓冲区上解析（读缓冲区归本次回调独占，可以原地解掩码）
+        char* buff = const_cast<char*>(data);
+        size_t consumed = ParseFrames(buff, len);
+        if (consumed < len && state_ == State::OPEN) {
+            recv_buffer_.assign(buff + consumed, buff + len);
+            recv_offset_ = 0;
+            if (recv_need_ > recv_buffer_.size()) {
+                recv_buffer_.reserve(recv_need_);
+            }
+        }
+        return;
+    }
+
+    // 拼接到上次不完整的帧之后
+    recv_buffer_.insert(recv_buffer_.end(), data, data + len);
+    ParsePending();
 }
 
 } // namespace uv_net
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "uv_net/websocket_deflate.h"
+#include <zlib.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace uv_net {
+
+// 每条消息压缩后以 Z_SYNC_FLUSH 结束，末尾固定为空的非压缩块 00 00 ff ff，发送时去掉、解压时补回
+static const char kDeflateTail[4] = {0x00, 0x00, static_cast<char>(0xff), static_cast<char>(0xff)};
+
+// zlib 对 8 位窗口的 raw deflate 实际使用 9 位，压缩和解压统一按 9 位起算
+static int ClampWindowBits(int bits) {
+    return bits < 9 ? 9 : (bits > 15 ? 15 : bits);
+}
+
+// 取出以 sep 分隔的下一项（去掉两端空白），列表结束返回 false
+static bool NextItem(const char*& p, const char* end, char sep, StringView& item) {
+    if (p >= end) {
+        return false;
+    }
+    const char* found = static_cast<const char*>(memchr(p, sep, static_cast<size_t>(end - p)));
+    const char* b = p;
+    const char* e = found ? found : end;
+    p = found ? found + 1 : end;
+    while (b < e && (*b == ' ' || *b == '\t')) {
+        ++b;
+    }
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t')) {
+        --e;
+    }
+    item = StringView(b, static_cast<size_t>(e - b));
+    return true;
+}
+
+// 解析窗口参数值 8～15（允许带引号），无效返回 -1
+static int ParseWindowBits(StringView value) {
+    if (value.Size() >= 2 && value[0] == '"' && value[value.Size() - 1] == '"') {
+        value = value.Substr(1, value.Size() - 2);
+    }
+    if (value.Size() == 1 && value[0] >= '8' && value[0] <= '9') {
+        return value[0] - '0';
+    }
+    if (value.Size() == 2 && value[0] == '1' && value[1] >= '0' && value[1] <= '5') {
+        return 10 + (value[1] - '0');
+    }
+    return -1;
+}
+
+// 解析一个 permessage-deflate 提议的参数，参数未知、重复或取值无效时拒绝该提议
+static bool AcceptOffer(StringView offer, const WebSocketDeflateOptions& options,
+                        WebSocketDeflateParams& params, std::string& response) {
+    const char* p = offer.Data();
+    const char* end = p + offer.Size();
+    StringView item;
+    if (!NextItem(p, end, ';', item) || !item.EqualsIgnoreCase("permessage-deflate")) {
+        return false;
+    }
+
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int server_bits = -1;         // 客户端要求的服务器窗口，-1 表示未要求
+    bool client_bits_offered = false;
+    int client_bits = -1;         // 客户端声明的自身窗口上限，-1 表示未给出
+    unsigned seen = 0;
+    while (NextItem(p, end, ';', item)) {
+        const char* eq = static_cast<const char*>(memchr(item.Data(), '=', item.Size()));
+        StringView name = eq ? StringView(item.Data(), static_cast<size_t>(eq - item.Data())) : item;
+        StringView value = eq ? item.Substr(static_cast<size_t>(eq - item.Data()) + 1) : StringView();
+        while (name.Size() > 0 && (name[name.Size() - 1] == ' ' || name[name.Size() - 1] == '\t')) {
+            name = name.Substr(0, name.Size() - 1);
+        }
+        while (value.Size() > 0 && (value[0] == ' ' || value[0] == '\t')) {
+            value = value.Substr(1);
+        }
+
+        unsigned bit;
+        if (name.EqualsIgnoreCase("server_no_context_takeover") && !eq) {
+            bit = 1;
+            server_no_context_takeover = true;
+        } else if (name.EqualsIgnoreCase("client_no_context_takeover") && !eq) {
+            bit = 2;
+            client_no_context_takeover = true;
+        } else if (name.EqualsIgnoreCase("server_max_window_bits") && eq) {
+            bit = 4;
+            server_bits = ParseWindowBits(value);
+            if (server_bits < 0) {
+                return false;
+            }
+        } else if (name.EqualsIgnoreCase("client_max_window_bits")) {
+            bit = 8;
+            client_bits_offered = true;
+            if (eq) {
+                client_bits = ParseWindowBits(value);
+                if (client_bits < 0) {
+                    return false;
+                }
+            }
+        } else {
+            return false;
+        }
+        if (seen & bit) {
+            return false;
+        }
+        seen |= bit;
+    }
+
+    // 服务器压缩窗口：zlib 不支持 8 位，客户端只接受 8 位窗口时拒绝该提议
+    params.server_max_window_bits = ClampWindowBits(options.server_max_window_bits);
+    if (server_bits >= 0) {
+        if (server_bits < 9) {
+            return false;
+        }
+        if (server_bits < params.server_max_window_bits) {
+            params.server_max_window_bits = server_bits;
+        }
+    }
+    // 客户端窗口只有在客户端声明支持 client_max_window_bits 时才能限制
+    params.client_max_window_bits = 15;
+    if (client_bits_offered) {
+        int bits = options.client_max_window_bits < 8 ? 8 : (options.client_max_window_bits > 15 ? 15 : options.client_max_window_bits);
+        if (client_bits >= 0 && client_bits < bits) {
+            bits = client_bits;
+        }
+        params.client_max_window_bits = bits;
+    }
+    params.server_no_context_takeover = server_no_context_takeover || options.server_no_context_takeover;
+    params.client_no_context_takeover = client_no_context_takeover || options.client_no_context_takeover;
+
+    response = "permessage-deflate";
+    if (params.server_no_context_takeover) {
+        response += "; server_no_context_takeover";
+    }
+    if (params.client_no_context_takeover) {
+        response += "; client_no_context_takeover";
+    }
+    if (server_bits >= 0 || params.server_max_window_bits < 15) {
+        response += "; server_max_window_bits=" + std::to_string(params.server_max_window_bits);
+    }
+    if (client_bits_offered && params.client_max_window_bits < 15) {
+        response += "; client_max_window_bits=" + std::to_string(params.client_max_window_bits);
+    }
+    return true;
+}
+
+bool NegotiateWebSocketDeflate(StringView offers, const WebSocketDeflateOptions& options,
+                               WebSocketDeflateParams& params, std::string& response) {
+    if (!options.enabled) {
+        return false;
+    }
+    const char* p = offers.Data();
+    const char* end = p + offers.Size();
+    StringView offer;
+    while (NextItem(p, end, ',', offer)) {
+        if (AcceptOffer(offer, options, params, response)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 以 Z_SYNC_FLUSH 压缩 [data, data + len)，去掉末尾的 00 00 ff ff，返回写入 out 的字节数，失败返回 -1
+static long DeflateSync(z_stream* strm, const char* data, size_t len, char* out, size_t out_len) {
+    strm->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    strm->avail_in = static_cast<uInt>(len);
+    strm->next_out = reinterpret_cast<Bytef*>(out);
+    strm->avail_out = static_cast<uInt>(out_len);
+    int ret = deflate(strm, Z_SYNC_FLUSH);
+    // 输出空间按 CompressBound 预留，一次调用即可完成
+    if ((ret != Z_OK && ret != Z_BUF_ERROR) || strm->avail_in != 0 || strm->avail_out == 0) {
+        return -1;
+    }
+    size_t produced = out_len - strm->avail_out;
+    if (produced < 4 || memcmp(out + produced - 4, kDeflateTail, 4) != 0) {
+        return -1;
+    }
+    return static_cast<long>(produced - 4);
+}
+
+bool DeflateMessage(const char* data, size_t len, int window_bits, int level, std::string& out) {
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if (deflateInit2(&strm, level, Z_DEFLATED, -ClampWindowBits(window_bits), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    size_t bound = WebSocketDeflate::CompressBound(len);
+    size_t offset = out.size();
+    out.resize(offset + bound);
+    long produced = DeflateSync(&strm, data, len, &out[offset], bound);
+    deflateEnd(&strm);
+    if (produced < 0) {
+        out.resize(offset);
+        return false;
+    }
+    out.resize(offset + static_cast<size_t>(produced));
+    return true;
+}
+
+WebSocketDeflate::WebSocketDeflate(const WebSocketDeflateParams& params, const WebSocketDeflateOptions& options,
+                                   size_t* memory_total)
+    : params_(params), level_(options.compression_level), mem_level_(options.mem_level),
+      min_compress_size_(options.min_compress_size), deflate_(nullptr), inflate_(nullptr),
+      reset_pending_(false), memory_(0), memory_total_(memory_total) {}
+
+WebSocketDeflate::~WebSocketDeflate() {
+    ReleaseDeflate();
+    ReleaseInflate();
+}
+
+// 每块内存前记录其大小，用于统计 zlib 占用
+void* WebSocketDeflate::Alloc(void* opaque, unsigned int items, unsigned int size) {
+    WebSocketDeflate* self = static_cast<WebSocketDeflate*>(opaque);
+    size_t bytes = static_cast<size_t>(items) * size;
+    char* block = static_cast<char*>(malloc(bytes + sizeof(max_align_t)));
+    if (!block) {
+        return Z_NULL;
+    }
+    memcpy(block, &bytes, sizeof(bytes));
+    self->memory_ += bytes;
+    if (self->memory_total_) {
+        *self->memory_total_ += bytes;
+    }
+    return block + sizeof(max_align_t);
+}
+
+void WebSocketDeflate::Free(void* opaque, void* address) {
+    WebSocketDeflate* self = static_cast<WebSocketDeflate*>(opaque);
+    char* block = static_cast<char*>(address) - sizeof(max_align_t);
+    size_t bytes;
+    memcpy(&bytes, block, sizeof(bytes));
+    self->memory_ -= bytes;
+    if (self->memory_total_) {
+        *self->memory_total_ -= bytes;
+    }
+    free(block);
+}
+
+bool WebSocketDeflate::EnsureDeflate() {
+    if (deflate_) {
+        return true;
+    }
+    deflate_ = new z_stream();
+    deflate_->zalloc = &WebSocketDeflate::Alloc;
+    deflate_->zfree = &WebSocketDeflate::Free;
+    deflate_->opaque = this;
+    if (deflateInit2(deflate_, level_, Z_DEFLATED, -ClampWindowBits(params_.server_max_window_bits),
+                     mem_level_, Z_DEFAULT_STRATEGY) != Z_OK) {
+        delete deflate_;
+        deflate_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool WebSocketDeflate::EnsureInflate() {
+    if (inflate_) {
+        return true;
+    }
+    inflate_ = new z_stream();
+    inflate_->zalloc = &WebSocketDeflate::Alloc;
+    inflate_->zfree = &WebSocketDeflate::Free;
+    inflate_->opaque = this;
+    if (inflateInit2(inflate_, -ClampWindowBits(params_.client_max_window_bits)) != Z_OK) {
+        delete inflate_;
+        inflate_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void WebSocketDeflate::ReleaseDeflate() {
+    reset_pending_ = false;
+    if (deflate_) {
+        deflateEnd(deflate_);
+        delete deflate_;
+        deflate_ = nullptr;
+    }
+}
+
+void WebSocketDeflate::ReleaseInflate() {
+    if (inflate_) {
+        inflateEnd(inflate_);
+        delete inflate_;
+        inflate_ = nullptr;
+    }
+}
+
+bool WebSocketDeflate::Compress(const char* data, size_t len, SendBuffer& out) {
+    if (!EnsureDeflate()) {
+        return false;
+    }
+    if (reset_pending_) {
+        deflateReset(deflate_);
+        reset_pending_ = false;
+    }
+    size_t bound = CompressBound(len);
+    long produced = DeflateSync(deflate_, data, len, out.WritableTail(bound), bound);
+    if (produced < 0) {
+        ReleaseDeflate();
+        return false;
+    }
+    out.Commit(static_cast<size_t>(produced));
+    // 不保留上下文时消息之间不需要 zlib 状态，释放以节省内存
+    if (params_.server_no_context_takeover) {
+        ReleaseDeflate();
+    }
+    return true;
+}
+
+WebSocketDeflate::Result WebSocketDeflate::Inflate(const char* data, size_t len, std::vector<char>& out, size_t max_size) {
+    inflate_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    inflate_->avail_in = static_cast<uInt>(len);
+    while (inflate_->avail_in > 0) {
+        size_t offset = out.size();
+        if (offset > max_size) {
+            return kTooLarge;
+        }
+        // 按输入的 4 倍预留输出空间，最多超出上限 1 字节以便检测超限
+        size_t chunk = static_cast<size_t>(inflate_->avail_in) * 4;
+        chunk = chunk < 4096 ? 4096 : chunk;
+        if (chunk > max_size - offset + 1) {
+            chunk = max_size - offset + 1;
+        }
+        out.resize(offset + chunk);
+        inflate_->next_out = reinterpret_cast<Bytef*>(out.data() + offset);
+        inflate_->avail_out = static_cast<uInt>(chunk);
+        int ret = inflate(inflate_, Z_SYNC_FLUSH);
+        out.resize(offset + chunk - inflate_->avail_out);
+        if (ret == Z_STREAM_END) {
+            // 发送方使用了 BFINAL 块，之后的数据开始新的流
+            inflateReset(inflate_);
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            return kError;
+        } else if (ret == Z_BUF_ERROR && inflate_->avail_out != 0) {
+            return kError;
+        }
+    }
+    // 输入已全部消耗，但可能还有待输出的数据
+    while (true) {
+        size_t offset = out.size();
+        if (offset > max_size) {
+            return kTooLarge;
+        }
+        size_t chunk = max_size - offset + 1 < 4096 ? max_size - offset + 1 : 4096;
+        out.resize(offset + chunk);
+        inflate_->next_out = reinterpret_cast<Bytef*>(out.data() + offset);
+        inflate_->avail_out = static_cast<uInt>(chunk);
+        int ret = inflate(inflate_, Z_SYNC_FLUSH);
+        out.resize(offset + chunk - inflate_->avail_out);
+        if (ret != Z_OK || inflate_->avail_out != 0) {
+            if (ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END) {
+                return kError;
+            }
+            break;
+        }
+    }
+    return out.size() > max_size ? kTooLarge : kOk;
+}
+
+WebSocketDeflate::Result WebSocketDeflate::Decompress(const char* data, size_t len, bool fin,
+                                                      std::vector<char>& out, size_t max_size) {
+    if (!EnsureInflate()) {
+        return kError;
+    }
+    Result result = len > 0 ? Inflate(data, len, out, max_size) : kOk;
+    if (result == kOk && fin) {
+        result = Inflate(kDeflateTail, sizeof(kDeflateTail), out, max_size);
+    }
+    if (result != kOk) {
+        ReleaseInflate();
+        return result;
+    }
+    if (fin && params_.client_no_context_takeover) {
+        ReleaseInflate();
+    }
+    return kOk;
+}
+
+} // namespace uv_net
@@ -0,0 +1,231 @@
+#include "uv_net/websocket_frame.h"
+#include "uv_net/websocket_deflate.h"
+#include <arpa/inet.h>
+#include <endian.h>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace uv_net {
+
+int ParseWebSocketFrameHeader(const char* data, size_t len, WebSocketFrame& frame) {
+    if (len < 2) {
+        return 0;
+    }
+    uint8_t first_byte = static_cast<uint8_t>(data[0]);
+    uint8_t second_byte = static_cast<uint8_t>(data[1]);
+    uint8_t payload_len = second_byte & 0x7F;
+
+    size_t header_len = 2;
+    if (payload_len == 126) {
+        header_len += 2;
+    } else if (payload_len == 127) {
+        header_len += 8;
+    }
+    bool masked = (second_byte & 0x80) != 0;
+    if (masked) {
+        header_len += 4;
+    }
+    if (len < header_len) {
+        return 0;
+    }
+
+    frame.fin = (first_byte & 0x80) != 0;
+    frame.rsv = (first_byte >> 4) & 0x07;
+    frame.opcode = static_cast<WebSocketOpcode>(first_byte & 0x0F);
+    frame.masked = masked;
+    frame.payload = nullptr;
+
+    switch (frame.opcode) {
+        case WebSocketOpcode::CONTINUATION:
+        case WebSocketOpcode::TEXT:
+        case WebSocketOpcode::BINARY:
+            break;
+        case WebSocketOpcode::CLOSE:
+        case WebSocketOpcode::PING:
+        case WebSocketOpcode::PONG:
+            // 控制帧不能分片，载荷不超过125字节
+            if (!frame.fin || payload_len > 125) {
+                return -1;
+            }
+            break;
+        default:
+            return -1;
+    }
+
+    if (payload_len < 126) {
+        frame.payload_length = payload_len;
+    } else if (payload_len == 126) {
+        uint16_t len16;
+        memcpy(&len16, data + 2, 2);
+        frame.payload_length = ntohs(len16);
+    } else {
+        uint64_t len64;
+        memcpy(&len64, data + 2, 8);
+        frame.payload_length = be64toh(len64);
+        // 64位长度的最高位必须为 0
+        if (frame.payload_length >> 63) {
+            return -1;
+        }
+    }
+
+    if (masked) {
+        memcpy(frame.masking_key, data + header_len - 4, 4);
+    } else {
+        memset(frame.masking_key, 0, 4);
+    }
+    return static_cast<int>(header_len);
+}
+
+size_t EncodeWebSocketFrameHeader(char* out, bool fin, WebSocketOpcode opcode, uint64_t payload_length, uint8_t rsv) {
+    // 第1字节：FIN + RSV + OPCODE
+    out[0] = static_cast<char>((fin ? 0x80 : 0) | ((rsv & 0x07) << 4) | (static_cast<uint8_t>(opcode) & 0x0F));
+    // 第2字节：MASK + PAYLOAD_LENGTH，服务器发送的数据不使用掩码
+    if (payload_length < 126) {
+        out[1] = static_cast<char>(payload_length);
+        return 2;
+    }
+    if (payload_length < 65536) {
+        out[1] = static_cast<char>(126);
+        uint16_t len16 = htons(static_cast<uint16_t>(payload_length));
+        memcpy(out + 2, &len16, 2);
+        return 4;
+    }
+    out[1] = static_cast<char>(127);
+    uint64_t len64 = htobe64(payload_length);
+    memcpy(out + 2, &len64, 8);
+    return 10;
+}
+
+// 引用计数与帧数据在同一次分配中，帧数据紧跟在 Block 之后，压缩帧（如有）紧跟在原始帧之后
+struct PreparedFrame::Block {
+    std::atomic<uint32_t> refs;
+    size_t size;
+    size_t compressed_size;
+    int window_bits;
+    WebSocketOpcode opcode;
+
+    char* Data() { return reinterpret_cast<char*>(this + 1); }
+    char* CompressedData() { return Data() + size; }
+
+    static void Release(Block* block) {
+        if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block->~Block();
+            ::operator delete(block);
+        }
+    }
+};
+
+PreparedFrame::Block* PreparedFrame::NewBlock(size_t size, size_t compressed_size, WebSocketOpcode opcode) {
+    void* mem = ::operator new(sizeof(Block) + size + compressed_size);
+    Block* block = new (mem) Block();
+    block->refs.store(1, std::memory_order_relaxed);
+    block->size = size;
+    block->compressed_size = compressed_size;
+    block->window_bits = 0;
+    block->opcode = opcode;
+    return block;
+}
+
+// 帧头与载荷写入 out，返回帧长度
+static size_t WriteFrame(char* out, const char* data, size_t len, WebSocketOpcode opcode, uint8_t rsv) {
+    size_t header_len = EncodeWebSocketFrameHeader(out, true, opcode, len, rsv);
+    if (len > 0) {
+        memcpy(out + header_len, data, len);
+    }
+    return header_len + len;
+}
+
+static size_t FrameSize(size_t len) {
+    return len < 126 ? 2 + len : (len < 65536 ? 4 + len : 10 + len);
+}
+
+PreparedFrame::PreparedFrame(const char* data, size_t len, WebSocketOpcode opcode)
+    : block_(NewBlock(FrameSize(len), 0, opcode)) {
+    WriteFrame(block_->Data(), data, len, opcode, 0);
+}
+
+PreparedFrame PreparedFrame::Deflated(const char* data, size_t len, WebSocketOpcode opcode, int window_bits, int level) {
+    std::string compressed;
+    if (!DeflateMessage(data, len, window_bits, level, compressed) || compressed.size() >= len) {
+        return PreparedFrame(data, len, opcode);
+    }
+
+    PreparedFrame frame;
+    frame.block_ = NewBlock(FrameSize(len), FrameSize(compressed.size()), opcode);
+    frame.block_->window_bits = window_bits < 9 ? 9 : window_bits;
+    WriteFrame(frame.block_->Data(), data, len, opcode, 0);
+    WriteFrame(frame.block_->CompressedData(), compressed.data(), compressed.size(), opcode, kWebSocketRsv1);
+    return frame;
+}
+
+PreparedFrame::PreparedFrame(const PreparedFrame& other) : block_(other.block_) {
+    if (block_) {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PreparedFrame& PreparedFrame::operator=(const PreparedFrame& other) {
+    if (this != &other) {
+        PreparedFrame copy(other);
+        std::swap(block_, copy.block_);
+    }
+    return *this;
+}
+
+PreparedFrame& PreparedFrame::operator=(PreparedFrame&& other) noexcept {
+    if (this != &other) {
+        if (block_) {
+            Block::Release(block_);
+        }
+        block_ = other.block_;
+        other.block_ = nullptr;
+    }
+    return *this;
+}
+
+PreparedFrame::~PreparedFrame() {
+    if (block_) {
+        Block::Release(block_);
+    }
+}
+
+const char* PreparedFrame::Data() const {
+    return block_ ? block_->Data() : nullptr;
+}
+
+size_t PreparedFrame::Size() const {
+    return block_ ? block_->size : 0;
+}
+
+WebSocketOpcode PreparedFrame::Opcode() const {
+    return block_ ? block_->opcode : WebSocketOpcode::BINARY;
+}
+
+const char* PreparedFrame::CompressedData() const {
+    return block_ && block_->compressed_size > 0 ? block_->CompressedData() : nullptr;
+}
+
+size_t PreparedFrame::CompressedSize() const {
+    return block_ ? block_->compressed_size : 0;
+}
+
+int PreparedFrame::CompressedWindowBits() const {
+    return block_ ? block_->window_bits : 0;
+}
+
+Buffer PreparedFrame::ToBuffer(bool compressed) const {
+    if (!block_ || (compressed && block_->compressed_size == 0)) {
+        return Buffer();
+    }
+    block_->refs.fetch_add(1, std::memory_order_relaxed);
+    // 释放函数只捕获 Block 指针，存放在 std::function 的内联存储中，不分配内存
+    Block* block = block_;
+    char* data = compressed ? block->CompressedData() : block->Data();
+    size_t size = compressed ? block->compressed_size : block->size;
+    return Buffer(data, size, [block](char*, size_t) {
+        Block::Release(block);
+    });
+}
+
+} // namespace uv_net
@@ -0,0 +1,252 @@
+#include "uv_net/websocket_handshake.h"
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+#include <cstring>
+
+namespace uv_net {
+
+static const char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const size_t kWebSocketKeySize = 24;
+static const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static bool IsBase64Char(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '/';
+}
+
+// 从逗号分隔的列表中取出下一项（去掉两端空白），列表结束返回 false
+static bool NextToken(const char*& p, const char* end, StringView& token) {
+    if (p >= end) {
+        return false;
+    }
+    const char* comma = static_cast<const char*>(memchr(p, ',', static_cast<size_t>(end - p)));
+    const char* b = p;
+    const char* e = comma ? comma : end;
+    p = comma ? comma + 1 : end;
+    while (b < e && (*b == ' ' || *b == '\t')) {
+        ++b;
+    }
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t')) {
+        --e;
+    }
+    token = StringView(b, static_cast<size_t>(e - b));
+    return true;
+}
+
+// 列表中是否包含 token（大小写不敏感），如 Connection: keep-alive, Upgrade
+static bool HasToken(StringView value, StringView token) {
+    const char* p = value.Data();
+    const char* end = p + value.Size();
+    StringView item;
+    while (NextToken(p, end, item)) {
+        if (item.EqualsIgnoreCase(token)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ParseWebSocketUpgrade(const char* data, size_t head_len, WebSocketUpgradeRequest& req) {
+    if (!HttpParser::ParseHead(data, head_len, req.http)) {
+        return 400;
+    }
+    const HttpRequest& http = req.http;
+    if (http.method != StringView("GET", 3) || http.minor_version < 1) {
+        return 400;
+    }
+
+    // 头部只遍历一次，按名称长度分派后再比较，同时取出所有需要的字段
+    StringView upgrade;
+    StringView connection;
+    StringView version;
+    req.key = StringView();
+    req.protocols = StringView();
+    req.extensions = StringView();
+    for (size_t i = 0; i < http.header_count; ++i) {
+        const HttpHeader& header = http.headers[i];
+        switch (header.name.Size()) {
+            case 7:
+                if (header.name.EqualsIgnoreCase(StringView("Upgrade", 7))) {
+                    upgrade = header.value;
+                }
+                break;
+            case 10:
+                if (header.name.EqualsIgnoreCase(StringView("Connection", 10))) {
+                    connection = header.value;
+                }
+                break;
+            case 17:
+                if (header.name.EqualsIgnoreCase(StringView("Sec-WebSocket-Key", 17))) {
+                    req.key = header.value;
+                }
+                break;
+            case 21:
+                if (header.name.EqualsIgnoreCase(StringView("Sec-WebSocket-Version", 21))) {
+                    version = header.value;
+                }
+                break;
+            case 22:
+                if (header.name.EqualsIgnoreCase(StringView("Sec-WebSocket-Protocol", 22))) {
+                    req.protocols = header.value;
+                }
+                break;
+            case 24:
+                if (header.name.EqualsIgnoreCase(StringView("Sec-WebSocket-Extensions", 24))) {
+                    req.extensions = header.value;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!HasToken(upgrade, StringView("websocket", 9)) || !HasToken(connection, StringView("upgrade", 7))) {
+        return 400;
+    }
+    if (version != StringView("13", 2)) {
+        return 426;
+    }
+    // 16字节随机数的 Base64 编码：22个字符加 "=="
+    if (req.key.Size() != kWebSocketKeySize || req.key[22] != '=' || req.key[23] != '=') {
+        return 400;
+    }
+    for (size_t i = 0; i < 22; ++i) {
+        if (!IsBase64Char(req.key[i])) {
+            return 400;
+        }
+    }
+    return 0;
+}
+
+// 每个线程复用一个摘要上下文；OpenSSL 3 下预先取出算法实现，避免每次握手都按名称查找
+namespace {
+struct Sha1Context {
+    EVP_MD_CTX* ctx;
+    const EVP_MD* md;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MD* fetched;
+
+    Sha1Context() : ctx(EVP_MD_CTX_new()), md(nullptr), fetched(EVP_MD_fetch(nullptr, "SHA1", nullptr)) {
+        md = fetched ? fetched : EVP_sha1();
+    }
+    ~Sha1Context() {
+        EVP_MD_CTX_free(ctx);
+        EVP_MD_free(fetched);
+    }
+#else
+    Sha1Context() : ctx(EVP_MD_CTX_new()), md(EVP_sha1()) {}
+    ~Sha1Context() { EVP_MD_CTX_free(ctx); }
+#endif
+};
+} // namespace
+
+void ComputeWebSocketAccept(StringView key, char* out) {
+    static thread_local Sha1Context sha1;
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    EVP_DigestInit_ex(sha1.ctx, sha1.md, nullptr);
+    EVP_DigestUpdate(sha1.ctx, key.Data(), key.Size());
+    EVP_DigestUpdate(sha1.ctx, kWebSocketGuid, sizeof(kWebSocketGuid) - 1);
+    EVP_DigestFinal_ex(sha1.ctx, digest, &digest_len);
+
+    // 20字节摘要：6组完整的3字节，最后2字节补一个 '='
+    char* p = out;
+    size_t i = 0;
+    for (; i + 3 <= 20; i += 3) {
+        uint32_t v = (static_cast<uint32_t>(digest[i]) << 16) | (static_cast<uint32_t>(digest[i + 1]) << 8) | digest[i + 2];
+        *p++ = kBase64Chars[(v >> 18) & 0x3F];
+        *p++ = kBase64Chars[(v >> 12) & 0x3F];
+        *p++ = kBase64Chars[(v >> 6) & 0x3F];
+        *p++ = kBase64Chars[v & 0x3F];
+    }
+    uint32_t v = (static_cast<uint32_t>(digest[i]) << 16) | (static_cast<uint32_t>(digest[i + 1]) << 8);
+    *p++ = kBase64Chars[(v >> 18) & 0x3F];
+    *p++ = kBase64Chars[(v >> 12) & 0x3F];
+    *p++ = kBase64Chars[(v >> 6) & 0x3F];
+    *p++ = '=';
+}
+
+StringView SelectWebSocketProtocol(StringView offered, const std::vector<std::string>& supported) {
+    const char* p = offered.Data();
+    const char* end = p + offered.Size();
+    StringView item;
+    while (NextToken(p, end, item)) {
+        for (const std::string& name : supported) {
+            // 子协议名称区分大小写
+            if (item == StringView(name)) {
+                return item;
+            }
+        }
+    }
+    return StringView();
+}
+
+static char* Append(char* p, const char* data, size_t len) {
+    memcpy(p, data, len);
+    return p + len;
+}
+
+size_t BuildWebSocketHandshakeResponse(char* out, size_t cap, const char* accept, StringView protocol,
+                                       StringView extensions) {
+    static const char kHead[] =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: ";
+    static const char kProtocol[] = "\r\nSec-WebSocket-Protocol: ";
+    static const char kExtensions[] = "\r\nSec-WebSocket-Extensions: ";
+
+    size_t len = sizeof(kHead) - 1 + kWebSocketAcceptSize + 4;
+    if (!protocol.Empty()) {
+        len += sizeof(kProtocol) - 1 + protocol.Size();
+    }
+    if (!extensions.Empty()) {
+        len += sizeof(kExtensions) - 1 + extensions.Size();
+    }
+    if (len > cap) {
+        return 0;
+    }
+
+    char* p = Append(out, kHead, sizeof(kHead) - 1);
+    p = Append(p, accept, kWebSocketAcceptSize);
+    if (!protocol.Empty()) {
+        p = Append(p, kProtocol, sizeof(kProtocol) - 1);
+        p = Append(p, protocol.Data(), protocol.Size());
+    }
+    if (!extensions.Empty()) {
+        p = Append(p, kExtensions, sizeof(kExtensions) - 1);
+        p = Append(p, extensions.Data(), extensions.Size());
+    }
+    p = Append(p, "\r\n\r\n", 4);
+    return static_cast<size_t>(p - out);
+}
+
+size_t BuildWebSocketRejectResponse(char* out, size_t cap, int status) {
+    const char* response;
+    switch (status) {
+        case 426:
+            response = "HTTP/1.1 426 Upgrade Required\r\n"
+                       "Sec-WebSocket-Version: 13\r\n"
+                       "Connection: close\r\n"
+                       "Content-Length: 0\r\n\r\n";
+            break;
+        case 431:
+            response = "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+                       "Connection: close\r\n"
+                       "Content-Length: 0\r\n\r\n";
+            break;
+        default:
+            response = "HTTP/1.1 400 Bad Request\r\n"
+                       "Connection: close\r\n"
+                       "Content-Length: 0\r\n\r\n";
+            break;
+    }
+    size_t len = strlen(response);
+    if (len > cap) {
+        return 0;
+    }
+    memcpy(out, response, len);
+    return len;
+}
+
+} // namespace uv_net
@@ -4,7 +4,9 @@
 
 namespace uv_net {
 
-WebSocketServer::WebSocketServer(uv_loop_t* loop, const ServerConfig& config) : TcpServer(loop, config) {
+WebSocketServer::WebSocketServer(uv_loop_t* loop, const ServerConfig& config) : TcpServer(loop, config), handshake_timeout_(kDefaultHandshakeTimeout), ping_enabled_(true),
+      max_missed_pongs_(kDefaultMaxMissedPongs), deflate_memory_(0), chunk_threshold_(0),
+      fragment_size_(0) {
     PLOG_INFO << "WebSocket Server created with buffer pool size: " << config.GetReadBufferSize();
 }
 
@@ -32,6 +34,29 @@ void WebSocketServer::OnClose(std::shared_ptr<Connection> conn) {
     TcpServer::OnClose(conn);
 }
 
+void WebSocketServer::OnMessageChunk(std::shared_ptr<Connection> conn, const char* data, size_t len, bool first, bool last) {
+    if (on_message_chunk_) {
+        on_message_chunk_(conn, data, len, first, last);
+    }
+}
+
+std::vector<char> WebSocketServer::AcquireMessageBuffer() {
+    if (message_buffers_.empty()) {
+        return std::vector<char>();
+    }
+    std::vector<char> buffer = std::move(message_buffers_.back());
+    message_buffers_.pop_back();
+    return buffer;
+}
+
+void WebSocketServer::ReleaseMessageBuffer(std::vector<char>&& buffer) {
+    if (buffer.capacity() == 0 || message_buffers_.size() >= kMaxPooledMessageBuffers) {
+        return;
+    }
+    buffer.clear();
+    message_buffers_.push_back(std::move(buffer));
+}
+
 // 重写父类的CreateConnection方法，创建WebSocketConnection对象
 TcpConnection* WebSocketServer::CreateConnection(TcpServer* server) {
     // 将TcpServer指针转换为WebSocketServer指针